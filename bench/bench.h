@@ -0,0 +1,67 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/** @file bench.h
+ *
+ *  @brief Host benchmark helpers (timing, deterministic random, checks)
+ */
+
+#ifndef __JO_BENCH_H__
+# define __JO_BENCH_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+/** @brief Monotonic clock in nanoseconds */
+static inline unsigned long long    bench_now_ns(void)
+{
+    struct timespec                 ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec);
+}
+
+/** @brief Deterministic random generator (the same sequence on every host) */
+static inline unsigned int          bench_random(unsigned int * const seed)
+{
+    *seed = *seed * 1103515245U + 12345U;
+    return ((*seed >> 16) & 0x7FFF);
+}
+
+/** @brief Abort the benchmark when a check fails */
+# define BENCH_CHECK(X)             do { if (!(X)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #X); exit(1); } } while (0)
+
+/** @brief Give the engine a heap like jo_core_init() does */
+void                                bench_init_memory(void);
+
+#endif /* !__JO_BENCH_H__ */
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,206 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** Collision broadphase with 1024 bullets (8x8) against 256 enemies (24x24) on a 320x224 screen.
+** Each frame every object moves, then the bullet-enemy hits are found three ways:
+**   - brute force: 1024 x 256 jo_aabb_intersect()
+**   - uniform grid: jo_collision_grid_build() with the enemies, then one query per bullet
+**   - sweep and prune: jo_collision_sap_find_pairs() on all 1280 boxes (bullet-bullet pairs ignored)
+** Every method must find the same hits.
+*/
+
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/collision.h"
+#include "bench.h"
+
+#define FRAME_COUNT                 (200)
+#define REPEAT_COUNT                (3)
+#define BULLET_COUNT                (1024)
+#define ENEMY_COUNT                 (256)
+#define BULLET_SIZE                 (8)
+#define ENEMY_SIZE                  (24)
+#define SCREEN_WIDTH                (320)
+#define SCREEN_HEIGHT               (224)
+
+typedef enum
+{
+    BENCH_BRUTE_FORCE,
+    BENCH_GRID,
+    BENCH_SWEEP_AND_PRUNE,
+    BENCH_METHOD_COUNT
+}                       bench_method;
+
+static const char       *method_names[BENCH_METHOD_COUNT] =
+{
+    "brute force",
+    "uniform grid",
+    "sweep and prune"
+};
+
+/* Enemies first, then bullets (sweep and prune works on a single array) */
+static jo_aabb          boxes[ENEMY_COUNT + BULLET_COUNT];
+static short            velocities[ENEMY_COUNT + BULLET_COUNT][2];
+static jo_collision_grid    grid;
+static jo_collision_sap     sap;
+static unsigned long long   hits;
+
+static void             bench_init_objects(void)
+{
+    unsigned int        seed;
+    int                 i;
+
+    seed = 1;
+    for (i = 0; i < ENEMY_COUNT + BULLET_COUNT; ++i)
+    {
+        boxes[i].width = i < ENEMY_COUNT ? ENEMY_SIZE : BULLET_SIZE;
+        boxes[i].height = boxes[i].width;
+        boxes[i].x = bench_random(&seed) % (SCREEN_WIDTH - boxes[i].width);
+        boxes[i].y = bench_random(&seed) % (SCREEN_HEIGHT - boxes[i].height);
+        velocities[i][0] = (short)(bench_random(&seed) % 7) - 3;
+        velocities[i][1] = (short)(bench_random(&seed) % 7) - 3;
+    }
+}
+
+static void             bench_move_objects(void)
+{
+    int                 i;
+
+    for (i = 0; i < ENEMY_COUNT + BULLET_COUNT; ++i)
+    {
+        boxes[i].x += velocities[i][0];
+        boxes[i].y += velocities[i][1];
+        if (boxes[i].x < 0 || boxes[i].x > SCREEN_WIDTH - boxes[i].width)
+        {
+            velocities[i][0] = -velocities[i][0];
+            boxes[i].x += JO_MULT_BY_2(velocities[i][0]);
+        }
+        if (boxes[i].y < 0 || boxes[i].y > SCREEN_HEIGHT - boxes[i].height)
+        {
+            velocities[i][1] = -velocities[i][1];
+            boxes[i].y += JO_MULT_BY_2(velocities[i][1]);
+        }
+    }
+}
+
+static bool             bench_grid_hit(const int id, void *extra)
+{
+    JO_UNUSED_ARG(id);
+    JO_UNUSED_ARG(extra);
+    ++hits;
+    return (false);
+}
+
+static void             bench_sap_pair(const int id1, const int id2, void *extra)
+{
+    JO_UNUSED_ARG(extra);
+    /* id1 < id2: a bullet-enemy pair has id1 < ENEMY_COUNT <= id2 */
+    if (id1 < ENEMY_COUNT && id2 >= ENEMY_COUNT)
+        ++hits;
+}
+
+static void             bench_frame(const bench_method method)
+{
+    int                 i;
+    int                 j;
+
+    switch (method)
+    {
+    case BENCH_BRUTE_FORCE:
+        for (i = ENEMY_COUNT; i < ENEMY_COUNT + BULLET_COUNT; ++i)
+            for (j = 0; j < ENEMY_COUNT; ++j)
+                if (jo_aabb_intersect(boxes + i, boxes + j))
+                    ++hits;
+        break;
+    case BENCH_GRID:
+        jo_collision_grid_build(&grid, boxes, ENEMY_COUNT);
+        for (i = ENEMY_COUNT; i < ENEMY_COUNT + BULLET_COUNT; ++i)
+            jo_collision_grid_query(&grid, boxes + i, bench_grid_hit, JO_NULL);
+        break;
+    default:
+        jo_collision_sap_find_pairs(&sap, boxes, ENEMY_COUNT + BULLET_COUNT, bench_sap_pair, JO_NULL);
+        break;
+    }
+}
+
+int                     main(void)
+{
+    unsigned long long  method_hits[BENCH_METHOD_COUNT];
+    unsigned long long  start;
+    unsigned long long  elapsed;
+    unsigned long long  best;
+    int                 method;
+    int                 repeat;
+    int                 frame;
+
+    bench_init_memory();
+    BENCH_CHECK(jo_collision_grid_init(&grid, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, ENEMY_COUNT, ENEMY_COUNT * 4));
+    BENCH_CHECK(jo_collision_sap_init(&sap, ENEMY_COUNT + BULLET_COUNT));
+    printf("%d bullets x %d enemies, %d frames\n", BULLET_COUNT, ENEMY_COUNT, FRAME_COUNT);
+    for (method = 0; method < BENCH_METHOD_COUNT; ++method)
+    {
+        /* The host is shared: keep the best of a few runs */
+        best = ~0ULL;
+        for (repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+        {
+            bench_init_objects();
+            hits = 0;
+            elapsed = 0;
+            for (frame = 0; frame < FRAME_COUNT; ++frame)
+            {
+                bench_move_objects();
+                start = bench_now_ns();
+                bench_frame((bench_method)method);
+                elapsed += bench_now_ns() - start;
+            }
+            if (elapsed < best)
+                best = elapsed;
+        }
+        method_hits[method] = hits;
+        printf("%s: %.1f us per frame, %llu hits\n", method_names[method], (double)best / (FRAME_COUNT * 1000.0), hits);
+    }
+    BENCH_CHECK(method_hits[BENCH_GRID] == method_hits[BENCH_BRUTE_FORCE]);
+    BENCH_CHECK(method_hits[BENCH_SWEEP_AND_PRUNE] == method_hits[BENCH_BRUTE_FORCE]);
+    jo_collision_sap_destroy(&sap);
+    jo_collision_grid_destroy(&grid);
+    BENCH_CHECK(jo_memory_get_stats()->used_bytes == 0);
+    return (0);
+}
+
+/*
+** END OF FILE
+*/
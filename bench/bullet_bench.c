@@ -0,0 +1,127 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** Bullet pattern throughput: 8 emitters run the demo script faster (no initial wait, shorter pauses)
+** until the 1024 bullet store is full, then keep refilling it for the rest of the run.
+** Each frame runs the emitters, moves the bullets, culls them on the screen edges and kills the ones
+** inside the shield and the ship core, like my_update() in main.c.
+** Reports bullets updated per millisecond (alive bullets at the start of the frame / frame time).
+*/
+
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/entity.h"
+#include "jo/bullet.h"
+#include "bench.h"
+
+#define FRAME_COUNT                 (10000)
+#define REPEAT_COUNT                (3)
+#define MAX_ENEMY_BULLETS           (1024)
+#define EMITTER_COUNT               (8)
+#define SHIP_CORE_SIZE              (6)
+#define SHIELD_SIZE                 (32)
+
+static const unsigned char bullet_script[] =
+{
+    /* 0 */ JO_BULLET_SPIRAL(4, JO_BULLET_SPEED(1.5), 11, 0),
+    /* 1 */ JO_BULLET_WAIT(2),
+    /* 2 */ JO_BULLET_LOOP(0, 30),
+    /* 3 */ JO_BULLET_AIMED(5, JO_BULLET_SPEED(2.5), 12, 0),
+    /* 4 */ JO_BULLET_WAVE(8, JO_BULLET_SPEED(1), 15, 30, 90),
+    /* 5 */ JO_BULLET_WAIT(2),
+    /* 6 */ JO_BULLET_LOOP(3, 20),
+    /* 7 */ JO_BULLET_LOOP(0, 0),
+};
+
+static jo_entity_store      bullets;
+static jo_bullet_emitter    emitters[EMITTER_COUNT];
+
+int                         main(void)
+{
+    unsigned long long      start;
+    unsigned long long      elapsed;
+    unsigned long long      best;
+    unsigned long long      updated;
+    int                     peak;
+    int                     repeat;
+    int                     frame;
+    int                     i;
+
+    bench_init_memory();
+    BENCH_CHECK(jo_entity_store_init(&bullets, MAX_ENEMY_BULLETS));
+    best = ~0ULL;
+    for (repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+    {
+        jo_entity_store_clear(&bullets);
+        for (i = 0; i < EMITTER_COUNT; ++i)
+        {
+            jo_bullet_emitter_init(&emitters[i], bullet_script, 0);
+            emitters[i].x = -140 + i * 40;
+            emitters[i].y = -JO_TV_HEIGHT_2 + 16;
+        }
+        updated = 0;
+        peak = 0;
+        start = bench_now_ns();
+        for (frame = 0; frame < FRAME_COUNT; ++frame)
+        {
+            updated += bullets.count;
+            for (i = 0; i < EMITTER_COUNT; ++i)
+                jo_bullet_emitter_update(&emitters[i], &bullets, 0, 80);
+            jo_entity_store_move(&bullets);
+            jo_entity_store_kill_outside(&bullets, -JO_TV_WIDTH_2, -JO_TV_HEIGHT_2, JO_TV_WIDTH_2, JO_TV_HEIGHT_2);
+            jo_entity_store_kill_inside(&bullets, 30 - SHIELD_SIZE / 2, 80 - SHIELD_SIZE / 2, 30 + SHIELD_SIZE / 2, 80 + SHIELD_SIZE / 2);
+            jo_entity_store_kill_inside(&bullets, -SHIP_CORE_SIZE / 2, 80 - SHIP_CORE_SIZE / 2, SHIP_CORE_SIZE / 2, 80 + SHIP_CORE_SIZE / 2);
+            if (bullets.count > peak)
+                peak = bullets.count;
+        }
+        elapsed = bench_now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    printf("frames: %d, emitters: %d, bullets per frame: %.0f (peak %d of %d)\n", FRAME_COUNT, EMITTER_COUNT,
+           (double)updated / FRAME_COUNT, peak, MAX_ENEMY_BULLETS);
+    printf("bullets updated per millisecond: %.0f\n", (double)updated * 1000000.0 / (double)best);
+    printf("frame time: %.1f us\n", (double)best / (FRAME_COUNT * 1000.0));
+    BENCH_CHECK(peak >= 1000);
+    jo_entity_store_destroy(&bullets);
+    BENCH_CHECK(jo_memory_get_stats()->used_bytes == 0);
+    return (0);
+}
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,208 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** jo_entity_store versus a jo_list of heap allocated structures (what main.c needed before the store)
+** with 512 and 1024 bullets. Each frame: respawn the missing bullets, move every bullet,
+** kill the ones that left the screen and the ones inside the player hitbox.
+** The fused rows move and cull in one pass (jo_entity_store_move_and_kill_outside()).
+*/
+
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/pool.h"
+#include "jo/list.h"
+#include "jo/entity.h"
+#include "bench.h"
+
+#define FRAME_COUNT                 (5000)
+#define REPEAT_COUNT                (5)
+#define SCREEN_WIDTH                (320)
+#define SCREEN_HEIGHT               (224)
+#define PLAYER_LEFT                 (150)
+#define PLAYER_TOP                  (180)
+#define PLAYER_SIZE                 (20)
+
+typedef struct
+{
+    int                 x;
+    int                 y;
+    int                 vx;
+    int                 vy;
+    short               sprite;
+    short               hp;
+}                       bench_bullet;
+
+static jo_entity_store  store;
+static jo_list          list;
+static unsigned int     seed;
+static unsigned long long   killed;
+
+static __inline__ void  bench_random_bullet(int * const x, int * const y, int * const vx, int * const vy)
+{
+    *x = JO_MULT_BY_65536(bench_random(&seed) % SCREEN_WIDTH);
+    *y = JO_MULT_BY_65536(bench_random(&seed) % 32);
+    *vx = (int)(bench_random(&seed) % 65536) - 32768;
+    *vy = 32768 + (int)(bench_random(&seed) % 131072);
+}
+
+static void             bench_store_frame(const int bullet_count)
+{
+    int                 x;
+    int                 y;
+    int                 vx;
+    int                 vy;
+
+    while (store.count < bullet_count)
+    {
+        bench_random_bullet(&x, &y, &vx, &vy);
+        jo_entity_spawn(&store, x, y, vx, vy, 0);
+    }
+    jo_entity_store_move(&store);
+    killed += jo_entity_store_kill_outside(&store, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    killed += jo_entity_store_kill_inside(&store, PLAYER_LEFT, PLAYER_TOP, PLAYER_LEFT + PLAYER_SIZE, PLAYER_TOP + PLAYER_SIZE);
+}
+
+static void             bench_store_fused_frame(const int bullet_count)
+{
+    int                 x;
+    int                 y;
+    int                 vx;
+    int                 vy;
+
+    while (store.count < bullet_count)
+    {
+        bench_random_bullet(&x, &y, &vx, &vy);
+        jo_entity_spawn(&store, x, y, vx, vy, 0);
+    }
+    killed += jo_entity_store_move_and_kill_outside(&store, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    killed += jo_entity_store_kill_inside(&store, PLAYER_LEFT, PLAYER_TOP, PLAYER_LEFT + PLAYER_SIZE, PLAYER_TOP + PLAYER_SIZE);
+}
+
+static bool             bench_list_bullet_is_dead(jo_node *node, void *extra)
+{
+    bench_bullet        *bullet;
+    int                 x;
+    int                 y;
+
+    JO_UNUSED_ARG(extra);
+    bullet = (bench_bullet *)node->data.ptr;
+    bullet->x += bullet->vx;
+    bullet->y += bullet->vy;
+    x = JO_DIV_BY_65536(bullet->x);
+    y = JO_DIV_BY_65536(bullet->y);
+    if (x < 0 || x > SCREEN_WIDTH || y < 0 || y > SCREEN_HEIGHT ||
+        (x >= PLAYER_LEFT && x < PLAYER_LEFT + PLAYER_SIZE && y >= PLAYER_TOP && y < PLAYER_TOP + PLAYER_SIZE))
+    {
+        jo_free(bullet);
+        ++killed;
+        return (true);
+    }
+    return (false);
+}
+
+static void             bench_list_frame(const int bullet_count)
+{
+    bench_bullet        *bullet;
+
+    while (list.count < bullet_count)
+    {
+        bullet = (bench_bullet *)jo_malloc_with_behaviour(sizeof(*bullet), JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE);
+        BENCH_CHECK(bullet != JO_NULL);
+        bench_random_bullet(&bullet->x, &bullet->y, &bullet->vx, &bullet->vy);
+        JO_ZERO(bullet->sprite);
+        JO_ZERO(bullet->hp);
+        BENCH_CHECK(jo_list_add_ptr(&list, bullet) != JO_NULL);
+    }
+    jo_list_sweep(&list, bench_list_bullet_is_dead, JO_NULL);
+}
+
+static void             bench_store_reset(void)
+{
+    jo_entity_store_clear(&store);
+}
+
+static void             bench_list_reset(void)
+{
+    jo_list_free_and_clear(&list);
+}
+
+static void             bench_run(const char * const name, void (*frame)(const int), void (*reset)(void), const int bullet_count)
+{
+    unsigned long long  start;
+    unsigned long long  elapsed;
+    unsigned long long  best;
+    int                 repeat;
+    int                 i;
+
+    /* The host is shared: keep the best of a few runs */
+    best = ~0ULL;
+    for (repeat = 0; repeat < REPEAT_COUNT; ++repeat)
+    {
+        reset();
+        seed = 1;
+        killed = 0;
+        start = bench_now_ns();
+        for (i = 0; i < FRAME_COUNT; ++i)
+            frame(bullet_count);
+        elapsed = bench_now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    printf("%s, %d bullets: %.0f ns per frame, %.2f ns per bullet, %llu killed\n", name, bullet_count,
+           (double)best / FRAME_COUNT, (double)best / ((double)FRAME_COUNT * bullet_count), killed);
+}
+
+int                     main(void)
+{
+    bench_init_memory();
+    BENCH_CHECK(jo_entity_store_init(&store, 1024));
+    jo_list_init(&list);
+    bench_run("jo_entity_store", bench_store_frame, bench_store_reset, 512);
+    bench_run("jo_entity_store", bench_store_frame, bench_store_reset, 1024);
+    bench_run("jo_entity_store fused", bench_store_fused_frame, bench_store_reset, 512);
+    bench_run("jo_entity_store fused", bench_store_fused_frame, bench_store_reset, 1024);
+    bench_run("jo_list + jo_malloc", bench_list_frame, bench_list_reset, 512);
+    bench_run("jo_list + jo_malloc", bench_list_frame, bench_list_reset, 1024);
+    bench_list_reset();
+    jo_entity_store_destroy(&store);
+    BENCH_CHECK(jo_memory_get_stats()->used_bytes == 0);
+    return (0);
+}
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,358 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** Stub Saturn hardware for the headless game build (see shmup_headless.c)
+**
+** VDP1, VDP2, SCU, SMPC and the on-chip registers of the SH-2 are plain memory mapped at their Saturn address,
+** so the engine writes its command tables, registers and VRAM as usual and nobody reads them.
+** The CD is the cd/ directory of the game on the host (GFS calls of fs.c), audio calls do nothing.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/math.h"
+#include "jo/malloc.h"
+#include "jo/time.h"
+#include "jo/fs.h"
+#include "jo/audio.h"
+#include "headless.h"
+
+#ifndef HEADLESS_CD_DIR
+# define HEADLESS_CD_DIR            "../cd"
+#endif
+#define HEADLESS_SECTOR_SIZE        (2048)
+#define HEADLESS_MAX_FILE_ID        (256)
+
+/** @brief Saturn address ranges backed by plain memory */
+static const struct
+{
+    unsigned long                   address;
+    unsigned long                   size;
+}                                   headless_memory_map[] =
+{
+    {0x06000000, 0x1000},           /* BIOS work area (system clock) */
+    {0x20100000, 0x1000},           /* SMPC */
+    {0x25C00000, 0x400000},         /* VDP1 VRAM and registers, VDP2 VRAM, CRAM and registers, SCU */
+    {0xFFFFF000, 0x1000},           /* SH-2 on-chip registers (FRC, TCR, interrupts) */
+};
+
+/* Start and end of the Saturn BSS (main() clears it, the host loader already did) */
+unsigned int                        _bstart;
+extern unsigned int                 _bend __attribute__((alias("_bstart")));
+
+void                                headless_init_hardware(void)
+{
+    unsigned int                    i;
+
+    for (i = 0; i < sizeof(headless_memory_map) / sizeof(*headless_memory_map); ++i)
+        if (mmap((void *)headless_memory_map[i].address, headless_memory_map[i].size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) != (void *)headless_memory_map[i].address)
+        {
+            fprintf(stderr, "Cannot map 0x%lX\n", headless_memory_map[i].address);
+            exit(1);
+        }
+}
+
+/*
+** VDP2 / SH-2
+*/
+
+unsigned short                      headless_vdp2_tvstat(void)
+{
+    static unsigned short           tvstat;
+    unsigned int                    frc;
+
+    /* Each read toggles VBLANK, so every wait of jo_core_run() ends at once.
+       Each VBLANK start advances the FRC by one tick: the fixed timestep mode always runs one update step per frame */
+    tvstat ^= 8;
+    if (tvstat & 8)
+    {
+        frc = jo_time_get_frc() + 1;
+        jo_time_poke_byte(RegisterHighFRC, frc >> 8);
+        jo_time_poke_byte(RegisterLowFRC, frc);
+    }
+    return (tvstat);
+}
+
+void                                slInitSystem(Uint16 tv_mode, TEXTURE *texture, Sint8 framerate)
+{
+    JO_UNUSED_ARG(tv_mode);
+    JO_UNUSED_ARG(texture);
+    JO_UNUSED_ARG(framerate);
+}
+
+void                                slDMACopy(void *src, void *dst, Uint32 size)
+{
+    memcpy(dst, src, size);
+}
+
+void                                slDMAWait(void)
+{
+}
+
+/*
+** CD (GFS)
+*/
+
+typedef struct
+{
+    FILE                            *file;
+    Sint32                          size;
+    void                            *async_buffer;
+    Sint32                          async_size;
+    Sint32                          async_read;
+}                                   headless_file;
+
+static char                         *headless_file_paths[HEADLESS_MAX_FILE_ID];
+static int                          headless_file_count;
+static char                         headless_current_dir[1024] = HEADLESS_CD_DIR;
+static char                         headless_loaded_dir[1024];
+
+Sint32                              GFS_Init(Sint32 open_max, void *work, GfsDirTbl *dirtbl)
+{
+    DIR                             *dir;
+    Sint32                          count;
+
+    JO_UNUSED_ARG(open_max);
+    JO_UNUSED_ARG(work);
+    JO_UNUSED_ARG(dirtbl);
+    if ((dir = opendir(HEADLESS_CD_DIR)) == JO_NULL)
+    {
+        fprintf(stderr, "%s: %s\n", HEADLESS_CD_DIR, strerror(errno));
+        return (0);
+    }
+    /* Number of directory records, like the CD version (with . and ..) */
+    for (count = 0; readdir(dir) != JO_NULL; ++count)
+        ;
+    closedir(dir);
+    return (count);
+}
+
+Sint32                              GFS_NameToId(Sint8 *fname)
+{
+    char                            path[1024];
+    char                            *slash;
+    int                             id;
+
+    if (strcmp((char *)fname, JO_PARENT_DIR) == 0)
+    {
+        strcpy(path, headless_current_dir);
+        if ((slash = strrchr(path, '/')) != JO_NULL && strcmp(path, HEADLESS_CD_DIR) != 0)
+            *slash = '\0';
+    }
+    else if (snprintf(path, sizeof(path), "%s/%s", headless_current_dir, (char *)fname) >= (int)sizeof(path))
+        return (GFS_ERR_NEXIST);
+    if (access(path, R_OK) != 0)
+        return (GFS_ERR_NEXIST);
+    for (id = 0; id < headless_file_count; ++id)
+        if (strcmp(headless_file_paths[id], path) == 0)
+            return (id);
+    if (headless_file_count >= HEADLESS_MAX_FILE_ID)
+        return (GFS_ERR_FID);
+    headless_file_paths[headless_file_count] = strdup(path);
+    return (headless_file_count++);
+}
+
+Sint32                              GFS_LoadDir(Sint32 fid, GfsDirTbl *dirtbl)
+{
+    JO_UNUSED_ARG(dirtbl);
+    if (fid < 0 || fid >= headless_file_count)
+        return (GFS_ERR_FID);
+    strcpy(headless_loaded_dir, headless_file_paths[fid]);
+    return (GFS_ERR_OK);
+}
+
+Sint32                              GFS_SetDir(GfsDirTbl *dirtbl)
+{
+    JO_UNUSED_ARG(dirtbl);
+    strcpy(headless_current_dir, headless_loaded_dir);
+    return (GFS_ERR_OK);
+}
+
+GfsHn                               GFS_Open(Sint32 fid)
+{
+    headless_file                   *file;
+
+    if (fid < 0 || fid >= headless_file_count || (file = calloc(1, sizeof(*file))) == JO_NULL)
+        return (JO_NULL);
+    if ((file->file = fopen(headless_file_paths[fid], "rb")) == JO_NULL)
+    {
+        free(file);
+        return (JO_NULL);
+    }
+    fseek(file->file, 0, SEEK_END);
+    file->size = ftell(file->file);
+    fseek(file->file, 0, SEEK_SET);
+    return ((GfsHn)file);
+}
+
+void                                GFS_Close(GfsHn gfs)
+{
+    fclose(((headless_file *)gfs)->file);
+    free(gfs);
+}
+
+void                                GFS_GetFileSize(GfsHn gfs, Sint32 *sctsz, Sint32 *nsct, Sint32 *lstsz)
+{
+    Sint32                          size;
+
+    size = ((headless_file *)gfs)->size;
+    *sctsz = HEADLESS_SECTOR_SIZE;
+    *nsct = size > 0 ? (size + HEADLESS_SECTOR_SIZE - 1) / HEADLESS_SECTOR_SIZE : 1;
+    *lstsz = size - (*nsct - 1) * HEADLESS_SECTOR_SIZE;
+}
+
+Sint32                              GFS_Load(Sint32 fid, Sint32 ofs, void *buf, Sint32 bsize)
+{
+    GfsHn                           gfs;
+    Sint32                          len;
+
+    if ((gfs = GFS_Open(fid)) == JO_NULL)
+        return (GFS_ERR_FID);
+    fseek(((headless_file *)gfs)->file, ofs * HEADLESS_SECTOR_SIZE, SEEK_SET);
+    len = fread(buf, 1, bsize, ((headless_file *)gfs)->file);
+    GFS_Close(gfs);
+    return (len);
+}
+
+Sint32                              GFS_Fread(GfsHn gfs, Sint32 nsct, void *buf, Sint32 bsize)
+{
+    return (fread(buf, 1, JO_MIN(nsct * HEADLESS_SECTOR_SIZE, bsize), ((headless_file *)gfs)->file));
+}
+
+Sint32                              GFS_Seek(GfsHn gfs, Sint32 ofs, Sint32 org)
+{
+    static const int                whence[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+
+    if (org < GFS_SEEK_SET || org > GFS_SEEK_END || fseek(((headless_file *)gfs)->file, ofs * HEADLESS_SECTOR_SIZE, whence[org]) != 0)
+        return (GFS_ERR_SEEK);
+    return (ftell(((headless_file *)gfs)->file) / HEADLESS_SECTOR_SIZE);
+}
+
+Sint32                              GFS_NwCdRead(GfsHn gfs, Sint32 nsct)
+{
+    JO_UNUSED_ARG(gfs);
+    JO_UNUSED_ARG(nsct);
+    return (GFS_ERR_OK);
+}
+
+Sint32                              GFS_SetTransPara(GfsHn gfs, Sint32 tsize)
+{
+    JO_UNUSED_ARG(gfs);
+    JO_UNUSED_ARG(tsize);
+    return (GFS_ERR_OK);
+}
+
+Sint32                              GFS_NwFread(GfsHn gfs, Sint32 nsct, void *buf, Sint32 bsize)
+{
+    headless_file                   *file;
+
+    file = (headless_file *)gfs;
+    file->async_buffer = buf;
+    file->async_size = JO_MIN(nsct * HEADLESS_SECTOR_SIZE, bsize);
+    file->async_read = 0;
+    return (GFS_ERR_OK);
+}
+
+Sint32                              GFS_NwExecOne(GfsHn gfs)
+{
+    headless_file                   *file;
+
+    file = (headless_file *)gfs;
+    file->async_read = fread(file->async_buffer, 1, file->async_size, file->file);
+    return (GFS_ERR_OK);
+}
+
+void                                GFS_NwGetStat(GfsHn gfs, Sint32 *amode, Sint32 *ndata)
+{
+    headless_file                   *file;
+
+    file = (headless_file *)gfs;
+    *amode = ftell(file->file) >= file->size ? GFS_SVR_COMPLETED : GFS_SVR_BUSY;
+    *ndata = file->async_read;
+}
+
+/*
+** Audio (no sound hardware: the calls only keep the PCM files loaded like on the Saturn)
+*/
+
+void                                jo_audio_init(void)
+{
+}
+
+void                                jo_audio_set_volume(const unsigned char vol)
+{
+    JO_UNUSED_ARG(vol);
+}
+
+void                                jo_audio_play_cd_track(const int fromTrack, const int totrack, const int loop)
+{
+    JO_UNUSED_ARG(fromTrack);
+    JO_UNUSED_ARG(totrack);
+    JO_UNUSED_ARG(loop);
+}
+
+void                                jo_audio_stop_cd(void)
+{
+}
+
+void                                jo_audio_play_sound_on_channel(jo_sound * const sound, const unsigned char channel)
+{
+    sound->current_playing_channel = channel;
+}
+
+bool                                jo_audio_load_pcm(const char * const filename, const jo_sound_mode mode, jo_sound *sound)
+{
+    char                            *pcm;
+    int                             len;
+
+    if ((pcm = jo_fs_read_file(filename, &len)) == JO_NULL)
+        return (false);
+    sound->mode = mode;
+    sound->data_length = len;
+    sound->data = pcm;
+    return (true);
+}
+
+/*
+** END OF FILE
+*/
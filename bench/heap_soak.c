@@ -0,0 +1,152 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** Heap fragmentation soak test: 10000 level restarts of the demo allocation pattern.
+** Boot assets stay allocated, then each restart loads the same level file in a temporary buffer,
+** allocates the level objects and plays a few frames of churn before freeing everything
+** in a different order. The heap must come back to the same state after every restart:
+** no leak and no growth of the highest address handed out by the allocator.
+*/
+
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/malloc.h"
+#include "bench.h"
+
+#define RESTART_COUNT               (10000)
+#define WARMUP_RESTART_COUNT        (100)
+#define FRAMES_PER_RESTART          (30)
+#define LEVEL_OBJECT_COUNT          (48)
+#define NODE_COUNT                  (64)
+#define VDP1_TABLES_PER_FRAME       (8)
+#define VDP1_TABLE_SIZE             (16 * 32 + 4)
+
+static unsigned char    *heap_begin;
+static unsigned int     heap_high;
+static unsigned int     seed = 1;
+static unsigned int     churn_seed = 1;
+
+static void             *soak_malloc(const unsigned int n, const jo_malloc_behaviour behaviour)
+{
+    unsigned char       *ptr;
+    unsigned int        high;
+
+    ptr = (unsigned char *)jo_malloc_with_behaviour(n, behaviour);
+    BENCH_CHECK(ptr != NULL);
+    if (heap_begin == NULL)
+        heap_begin = ptr;
+    high = (unsigned int)(ptr + n - heap_begin);
+    if (high > heap_high)
+        heap_high = high;
+    return (ptr);
+}
+
+static void             soak_level(void)
+{
+    void                *objects[LEVEL_OBJECT_COUNT];
+    void                *nodes[NODE_COUNT];
+    void                *tables[VDP1_TABLES_PER_FRAME];
+    void                *file;
+    int                 frame;
+    int                 i;
+
+    /* Restarting replays the same level: same file and object sizes every time */
+    seed = 1;
+    file = soak_malloc(2048 + bench_random(&seed) % 18432, JO_FAST_ALLOCATION);
+    for (i = 0; i < LEVEL_OBJECT_COUNT; ++i)
+        objects[i] = soak_malloc(16 + bench_random(&seed) % 1024, (jo_malloc_behaviour)(i % 3));
+    jo_free(file);
+    memset(nodes, 0, sizeof(nodes));
+    for (frame = 0; frame < FRAMES_PER_RESTART; ++frame)
+    {
+        for (i = 0; i < VDP1_TABLES_PER_FRAME; ++i)
+            tables[i] = soak_malloc(VDP1_TABLE_SIZE, JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE);
+        for (i = 0; i < NODE_COUNT; ++i)
+        {
+            if ((bench_random(&churn_seed) & 3) != 0)
+                continue;
+            if (nodes[i] == NULL)
+                nodes[i] = soak_malloc(12, JO_MALLOC_TRY_REUSE_BLOCK);
+            else
+            {
+                jo_free(nodes[i]);
+                nodes[i] = NULL;
+            }
+        }
+        for (i = 0; i < VDP1_TABLES_PER_FRAME; ++i)
+            jo_free(tables[i]);
+    }
+    /* restart_game(): everything goes, in a different order than allocated */
+    for (i = 0; i < NODE_COUNT; ++i)
+        if (nodes[i] != NULL)
+            jo_free(nodes[i]);
+    for (i = 0; i < LEVEL_OBJECT_COUNT; i += 2)
+        jo_free(objects[i]);
+    for (i = LEVEL_OBJECT_COUNT - 1; i > 0; i -= 2)
+        jo_free(objects[i]);
+}
+
+int                     main(void)
+{
+    void                *boot_assets[4];
+    unsigned int        used_after_boot;
+    unsigned int        high_after_warmup;
+    int                 restart;
+    int                 i;
+
+    bench_init_memory();
+    for (i = 0; i < 4; ++i)
+        boot_assets[i] = soak_malloc(8192 + i * 4096, JO_FAST_ALLOCATION);
+    used_after_boot = jo_memory_get_stats()->used_bytes;
+    high_after_warmup = 0;
+    for (restart = 0; restart < RESTART_COUNT; ++restart)
+    {
+        soak_level();
+        BENCH_CHECK(jo_memory_get_stats()->used_bytes == used_after_boot);
+        if (restart == WARMUP_RESTART_COUNT)
+            high_after_warmup = heap_high;
+    }
+    printf("restarts: %d\n", RESTART_COUNT);
+    printf("heap high after %d restarts: %u bytes, after %d restarts: %u bytes\n",
+           WARMUP_RESTART_COUNT, high_after_warmup, RESTART_COUNT, heap_high);
+    printf("peak used: %u bytes, free blocks: %d\n", jo_memory_get_stats()->peak_used_bytes, jo_memory_fragmentation());
+    BENCH_CHECK(heap_high == high_after_warmup);
+    for (i = 0; i < 4; ++i)
+        jo_free(boot_assets[i]);
+    BENCH_CHECK(jo_memory_get_stats()->used_bytes == 0);
+    BENCH_CHECK(jo_memory_fragmentation() == 0);
+    printf("ok\n");
+    return (0);
+}
+
+/*
+** END OF FILE
+*/
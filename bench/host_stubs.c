@@ -0,0 +1,78 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** Stubs for the engine functions that need the Saturn hardware (VDP2 text, error screen)
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/tools.h"
+#include "jo/core.h"
+#include "bench.h"
+
+void                    jo_add_memory_zone(unsigned char *ptr, const unsigned int size_in_bytes, const bool is_zeroed);
+
+char                    __jo_last_error[JO_PRINTF_BUF_SIZE];
+char                    __jo_sprintf_buf[JO_PRINTF_BUF_SIZE];
+
+void                    __jo_core_error(char *message, const char *function)
+{
+    fprintf(stderr, "%s: %s\n", function, message);
+    exit(1);
+}
+
+void                    jo_print(int x, int y, char * str)
+{
+    JO_UNUSED_ARG(x);
+    JO_UNUSED_ARG(y);
+    JO_UNUSED_ARG(str);
+}
+
+void                    jo_memset(const void * const restrict ptr, const int value, unsigned int num)
+{
+    memset((void *)ptr, value & 0xff, num);
+}
+
+void                    bench_init_memory(void)
+{
+    static unsigned char    global_memory[JO_GLOBAL_MEMORY_SIZE_FOR_MALLOC];
+
+    jo_add_memory_zone(global_memory, sizeof(global_memory), true);
+}
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,119 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** jo_list traversal with 2048 nodes.
+** Nodes are added while the game keeps allocating other things (16 to 64 bytes), like main.c does,
+** then the list is traversed, half of the nodes are replaced in random order and the list is traversed again.
+** Built twice: list_bench uses the default node chunks, list_bench_per_node allocates every node on its own.
+*/
+
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/pool.h"
+#include "jo/list.h"
+#include "bench.h"
+
+#define NODE_COUNT                  (2048)
+#define TRAVERSAL_COUNT             (2000)
+
+static jo_list          list;
+static void             *other_allocations[NODE_COUNT];
+static jo_node          *nodes[NODE_COUNT];
+static unsigned int     seed = 1;
+
+static double           bench_traversal(void)
+{
+    unsigned long long  start;
+    volatile int        sink;
+    jo_node             *tmp;
+    int                 sum;
+    int                 i;
+
+    start = bench_now_ns();
+    for (i = 0; i < TRAVERSAL_COUNT; ++i)
+    {
+        sum = 0;
+        for (tmp = list.first; tmp != JO_NULL; tmp = tmp->next)
+            sum += tmp->data.integer;
+        sink = sum;
+    }
+    return ((double)(bench_now_ns() - start) / ((double)TRAVERSAL_COUNT * list.count));
+}
+
+int                     main(void)
+{
+    unsigned int        used_without_list;
+    unsigned int        used_with_list;
+    unsigned int        slot;
+    int                 i;
+
+    bench_init_memory();
+    jo_list_init(&list);
+    for (i = 0; i < NODE_COUNT; ++i)
+    {
+        nodes[i] = jo_list_add(&list, (jo_list_data)i);
+        BENCH_CHECK(nodes[i] != JO_NULL);
+        other_allocations[i] = jo_malloc_with_behaviour(16 + bench_random(&seed) % 48, JO_MALLOC_TRY_REUSE_BLOCK);
+        BENCH_CHECK(other_allocations[i] != JO_NULL);
+    }
+    printf("nodes: %d, first chunk: %d nodes, max chunk: %d nodes\n", NODE_COUNT, JO_LIST_FIRST_CHUNK_NODES, JO_LIST_MAX_CHUNK_NODES);
+    used_with_list = jo_memory_get_stats()->used_bytes;
+    printf("traversal after build: %.2f ns per node\n", bench_traversal());
+    for (i = 0; i < NODE_COUNT / 2; ++i)
+    {
+        slot = bench_random(&seed) % NODE_COUNT;
+        jo_list_remove(&list, nodes[slot]);
+        nodes[slot] = jo_list_add(&list, (jo_list_data)(int)slot);
+        BENCH_CHECK(nodes[slot] != JO_NULL);
+    }
+    printf("traversal after %d random replacements: %.2f ns per node\n", NODE_COUNT / 2, bench_traversal());
+    jo_list_clear(&list);
+    BENCH_CHECK(list.chunks == JO_NULL);
+    used_without_list = jo_memory_get_stats()->used_bytes;
+    printf("heap per node: %.1f bytes (host pointers are 8 bytes)\n", (double)(used_with_list - used_without_list) / NODE_COUNT);
+    /* An empty list must keep nothing in the heap */
+    jo_list_add(&list, (jo_list_data)0);
+    jo_list_remove_first(&list);
+    BENCH_CHECK(list.chunks == JO_NULL);
+    for (i = 0; i < NODE_COUNT; ++i)
+        jo_free(other_allocations[i]);
+    BENCH_CHECK(jo_memory_get_stats()->used_bytes == 0);
+    return (0);
+}
+
+/*
+** END OF FILE
+*/
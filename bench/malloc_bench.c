@@ -0,0 +1,173 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** jo_malloc_with_behaviour() microbenchmark replaying the demo allocation churn:
+**   - VDP1 command tables allocated and released every frame (JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE)
+**   - laser blasts (up to 3 alive) and enemy waves as 12 bytes list nodes (JO_MALLOC_TRY_REUSE_BLOCK)
+**   - a large temporary buffer (file load) at every level restart (JO_FAST_ALLOCATION)
+** Reports allocations per second and the worst allocation latency (includes the clock overhead).
+*/
+
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/malloc.h"
+#include "bench.h"
+
+#define FRAME_COUNT                 (100000)
+#define VDP1_TABLES_PER_FRAME       (8)
+#define VDP1_TABLE_SIZE             (16 * 32 + 4)
+#define NODE_SIZE                   (12)
+#define MAX_LASERS                  (3)
+#define MAX_ENEMIES                 (64)
+#define FRAMES_PER_LEVEL_RESTART    (3600)
+
+typedef struct
+{
+    void                *ptr;
+    int                 ttl;
+}                       bench_object;
+
+static bench_object     lasers[MAX_LASERS];
+static bench_object     enemies[MAX_ENEMIES];
+static unsigned long long   worst_ns;
+static unsigned long long   allocation_count;
+
+static void             *bench_malloc(const unsigned int n, const jo_malloc_behaviour behaviour, const bool measure)
+{
+    unsigned long long  start;
+    unsigned long long  elapsed;
+    void                *ptr;
+
+    if (!measure)
+        ptr = jo_malloc_with_behaviour(n, behaviour);
+    else
+    {
+        start = bench_now_ns();
+        ptr = jo_malloc_with_behaviour(n, behaviour);
+        elapsed = bench_now_ns() - start;
+        if (elapsed > worst_ns)
+            worst_ns = elapsed;
+    }
+    BENCH_CHECK(ptr != NULL);
+    ++allocation_count;
+    return (ptr);
+}
+
+static void             bench_run(const bool measure)
+{
+    void                *tables[VDP1_TABLES_PER_FRAME];
+    void                *file;
+    unsigned int        seed;
+    int                 frame;
+    int                 level;
+    int                 alive;
+    int                 i;
+
+    seed = 1;
+    level = 0;
+    for (frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        if (frame % FRAMES_PER_LEVEL_RESTART == 0)
+        {
+            file = bench_malloc(4096 + bench_random(&seed) % 16384, JO_FAST_ALLOCATION, measure);
+            jo_free(file);
+            level = 0;
+        }
+        for (i = 0; i < VDP1_TABLES_PER_FRAME; ++i)
+            tables[i] = bench_malloc(VDP1_TABLE_SIZE, JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE, measure);
+        /* Autofire */
+        for (i = 0; i < MAX_LASERS; ++i)
+        {
+            if (lasers[i].ptr == NULL && (bench_random(&seed) & 7) == 0)
+            {
+                lasers[i].ptr = bench_malloc(NODE_SIZE, JO_MALLOC_TRY_REUSE_BLOCK, measure);
+                lasers[i].ttl = 40 + bench_random(&seed) % 40;
+            }
+            else if (lasers[i].ptr != NULL && --lasers[i].ttl <= 0)
+            {
+                jo_free(lasers[i].ptr);
+                lasers[i].ptr = NULL;
+            }
+        }
+        /* Enemy waves: a new level starts when every enemy is dead */
+        for (alive = 0, i = 0; i < MAX_ENEMIES; ++i)
+        {
+            if (enemies[i].ptr != NULL && --enemies[i].ttl <= 0)
+            {
+                jo_free(enemies[i].ptr);
+                enemies[i].ptr = NULL;
+            }
+            alive += (enemies[i].ptr != NULL);
+        }
+        if (!alive)
+        {
+            for (i = 0; i <= level && i < MAX_ENEMIES; ++i)
+            {
+                enemies[i].ptr = bench_malloc(NODE_SIZE, JO_MALLOC_TRY_REUSE_BLOCK, measure);
+                enemies[i].ttl = 60 + bench_random(&seed) % 240;
+            }
+            ++level;
+        }
+        for (i = VDP1_TABLES_PER_FRAME - 1; i >= 0; --i)
+            jo_free(tables[i]);
+    }
+    for (i = 0; i < MAX_LASERS; ++i)
+        if (lasers[i].ptr != NULL)
+            jo_free(lasers[i].ptr);
+    for (i = 0; i < MAX_ENEMIES; ++i)
+        if (enemies[i].ptr != NULL)
+            jo_free(enemies[i].ptr);
+    memset(lasers, 0, sizeof(lasers));
+    memset(enemies, 0, sizeof(enemies));
+}
+
+int                     main(void)
+{
+    unsigned long long  start;
+    unsigned long long  elapsed;
+
+    bench_init_memory();
+    start = bench_now_ns();
+    bench_run(false);
+    elapsed = bench_now_ns() - start;
+    printf("frames: %d, allocations: %llu\n", FRAME_COUNT, allocation_count);
+    printf("allocations per second: %.0f (each with its jo_free())\n", (double)allocation_count * 1000000000.0 / (double)elapsed);
+    allocation_count = 0;
+    bench_run(true);
+    printf("worst allocation latency: %llu ns\n", worst_ns);
+    printf("heap usage: %d%%, fragmentation: %d%%\n", jo_memory_usage_percent(), jo_memory_fragmentation());
+    BENCH_CHECK(jo_memory_get_stats()->used_bytes == 0);
+    return (0);
+}
+
+/*
+** END OF FILE
+*/
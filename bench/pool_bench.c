@@ -0,0 +1,159 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** jo_pool versus jo_malloc_with_behaviour() for bullet sized objects.
+** 1024 objects are alive, then every frame 1000 of them are freed and 1000 new ones are spawned
+** in a scattered order (the order bullets leave the screen is not the order they were fired).
+** Reports the cost of one spawn + free pair and the worst frame.
+*/
+
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/pool.h"
+#include "bench.h"
+
+#define FRAME_COUNT                 (10000)
+#define OBJECT_COUNT                (1024)
+#define SPAWNS_PER_FRAME            (1000)
+#define OBJECT_SIZE                 (32)
+/* Odd stride: (i * SCATTER_STRIDE) % OBJECT_COUNT visits every slot once */
+#define SCATTER_STRIDE              (389)
+
+typedef enum
+{
+    BENCH_POOL,
+    BENCH_HEAP_SAME_BLOCK_SIZE,
+    BENCH_HEAP_REUSE_BLOCK
+}                       bench_allocator;
+
+static const char       *allocator_names[] =
+{
+    "jo_pool",
+    "jo_malloc (JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE)",
+    "jo_malloc (JO_MALLOC_TRY_REUSE_BLOCK)"
+};
+
+static jo_pool          pool;
+static void             *objects[OBJECT_COUNT];
+
+static __inline__ void  *bench_alloc(const bench_allocator allocator)
+{
+    void                *ptr;
+
+    switch (allocator)
+    {
+    case BENCH_POOL:
+        ptr = jo_pool_alloc(&pool);
+        break;
+    case BENCH_HEAP_SAME_BLOCK_SIZE:
+        ptr = jo_malloc_with_behaviour(OBJECT_SIZE, JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE);
+        break;
+    default:
+        ptr = jo_malloc_with_behaviour(OBJECT_SIZE, JO_MALLOC_TRY_REUSE_BLOCK);
+        break;
+    }
+    BENCH_CHECK(ptr != NULL);
+    return (ptr);
+}
+
+static __inline__ void  bench_free(const bench_allocator allocator, void *ptr)
+{
+    if (allocator == BENCH_POOL)
+        jo_pool_free(&pool, ptr);
+    else
+        jo_free(ptr);
+}
+
+static void             bench_run(const bench_allocator allocator)
+{
+    unsigned long long  start;
+    unsigned long long  frame_start;
+    unsigned long long  elapsed;
+    unsigned long long  worst_ns;
+    unsigned int        slot;
+    int                 frame;
+    int                 i;
+
+    worst_ns = 0;
+    for (i = 0; i < OBJECT_COUNT; ++i)
+        objects[i] = bench_alloc(allocator);
+    start = bench_now_ns();
+    for (frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        frame_start = bench_now_ns();
+        for (i = 0; i < SPAWNS_PER_FRAME; ++i)
+        {
+            slot = (unsigned int)(i * SCATTER_STRIDE + frame) % OBJECT_COUNT;
+            bench_free(allocator, objects[slot]);
+            objects[slot] = JO_NULL;
+        }
+        for (i = 0; i < SPAWNS_PER_FRAME; ++i)
+        {
+            slot = (unsigned int)(i * SCATTER_STRIDE + frame * 7) % OBJECT_COUNT;
+            while (objects[slot] != JO_NULL)
+                slot = (slot + 1) % OBJECT_COUNT;
+            objects[slot] = bench_alloc(allocator);
+            *((unsigned char *)objects[slot] + OBJECT_SIZE - 1) = (unsigned char)frame;
+        }
+        elapsed = bench_now_ns() - frame_start;
+        if (elapsed > worst_ns)
+            worst_ns = elapsed;
+    }
+    elapsed = bench_now_ns() - start;
+    for (i = 0; i < OBJECT_COUNT; ++i)
+        bench_free(allocator, objects[i]);
+    printf("%s:\n", allocator_names[allocator]);
+    printf("    %.1f ns per spawn + free, worst frame: %llu ns\n",
+           (double)elapsed / ((double)FRAME_COUNT * SPAWNS_PER_FRAME), worst_ns);
+}
+
+int                     main(void)
+{
+    bench_init_memory();
+    BENCH_CHECK(jo_pool_init(&pool, OBJECT_SIZE, OBJECT_COUNT));
+    printf("frames: %d, spawns and frees per frame: %d, alive: %d\n", FRAME_COUNT, SPAWNS_PER_FRAME, OBJECT_COUNT);
+    bench_run(BENCH_POOL);
+    BENCH_CHECK(pool.count == 0);
+    jo_pool_destroy(&pool);
+    bench_run(BENCH_HEAP_SAME_BLOCK_SIZE);
+    bench_run(BENCH_HEAP_REUSE_BLOCK);
+    BENCH_CHECK(jo_memory_get_stats()->used_bytes == 0);
+    return (0);
+}
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,312 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** Headless run of the demo shooter (main.c) for gameplay performance regressions.
+**
+** The game and the engine run unchanged on top of headless_stubs.c: jo_core_run() runs N frames as fast as
+** the host CPU allows, pad 1 follows an input script, then A+B+C+START is pressed to leave jo_core_run().
+** Each callback added by the game is timed with the host clock, its engine allocations are counted.
+**
+** Usage: shmup_headless [frame count] [input script]
+**
+** Script lines are "<frames> <keys>", keys are any of U D L R A B C X Y Z S (Start) or - for none,
+** the script restarts when it ends. Without a script the ship moves around with autofire and the game
+** is restarted every 600 frames (see headless_default_script).
+**
+** Linked with -Wl,--wrap so the engine keeps its own main() and jo_core_add_*callback():
+** __wrap_main() maps the hardware before the engine starts and prints the report when it returns.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <dlfcn.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/input.h"
+#include "bench.h"
+#include "headless.h"
+
+#define DEFAULT_FRAME_COUNT         (3600)
+#define MAX_SCRIPT_STEPS            (256)
+#define MAX_CALLBACKS               (16)
+
+typedef struct
+{
+    int                             frames;
+    unsigned short                  keys;
+}                                   script_step;
+
+typedef struct
+{
+    jo_event_callback               callback;
+    const char                      *phase;
+    int                             event_id;
+    unsigned int                    calls;
+    unsigned int                    malloc_count;
+    unsigned long long              total_ns;
+    unsigned long long              max_ns;
+}                                   timed_callback;
+
+static const char                   headless_default_script[] =
+    "120 B\n"
+    "90 BL\n"
+    "90 BR\n"
+    "60 BLU\n"
+    "60 BRD\n"
+    "60 A\n"
+    "119 B\n"
+    "1 S\n";
+
+static script_step                  script[MAX_SCRIPT_STEPS];
+static int                          script_length;
+static int                          frame_count = DEFAULT_FRAME_COUNT;
+/* Frames run by jo_core_run() */
+static int                          frame;
+static timed_callback               callbacks[MAX_CALLBACKS];
+static int                          callback_count;
+static unsigned long long           run_start_ns;
+
+int                                 __real_main(void);
+int                                 __real_jo_core_add_callback(const jo_event_callback callback);
+int                                 __real_jo_core_add_update_callback(const jo_event_callback callback);
+
+/*
+** Input script
+*/
+
+static unsigned short               parse_keys(const char *keys)
+{
+    static const char               names[] = "UDLRABCXYZS";
+    static const unsigned short     values[] = {JO_KEY_UP, JO_KEY_DOWN, JO_KEY_LEFT, JO_KEY_RIGHT, JO_KEY_A, JO_KEY_B, JO_KEY_C,
+                                                JO_KEY_X, JO_KEY_Y, JO_KEY_Z, JO_KEY_START};
+    const char                      *key;
+    unsigned short                  result;
+
+    for (result = 0; *keys && *keys != '\n'; ++keys)
+        if ((key = strchr(names, *keys)) != NULL)
+            result |= values[key - names];
+    return (result);
+}
+
+static void                         parse_script(const char *text)
+{
+    char                            keys[32];
+    int                             frames;
+    int                             len;
+
+    for (script_length = 0; sscanf(text, " %d %31s%n", &frames, keys, &len) == 2; text += len)
+    {
+        BENCH_CHECK(script_length < MAX_SCRIPT_STEPS && frames > 0);
+        script[script_length].frames = frames;
+        script[script_length++].keys = parse_keys(keys);
+    }
+    BENCH_CHECK(script_length > 0);
+}
+
+static void                         load_script(const char * const filename)
+{
+    FILE                            *file;
+    char                            *text;
+    long                            size;
+
+    if ((file = fopen(filename, "rb")) == NULL)
+    {
+        perror(filename);
+        exit(1);
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    BENCH_CHECK((text = calloc(1, size + 1)) != NULL);
+    BENCH_CHECK(fread(text, 1, size, file) == (size_t)size);
+    fclose(file);
+    parse_script(text);
+    free(text);
+}
+
+static unsigned short               script_keys(int at)
+{
+    int                             i;
+    int                             period;
+
+    for (period = 0, i = 0; i < script_length; ++i)
+        period += script[i].frames;
+    at %= period;
+    for (i = 0; at >= script[i].frames; ++i)
+        at -= script[i].frames;
+    return (script[i].keys);
+}
+
+/* Replaces the SMPC read of jo_input_update(), called by jo_core_run() at the end of each frame for the next one
+   (the first frame runs without input, like on the Saturn) */
+void                                __wrap_jo_input_update(void)
+{
+    unsigned short                  previous;
+
+    ++frame;
+    previous = jo_inputs[0].pressed;
+    jo_inputs[0].id = PER_ID_StnPad;
+    if (frame < frame_count)
+        jo_inputs[0].pressed = script_keys(frame);
+    else
+        jo_inputs[0].pressed = JO_KEY_A | JO_KEY_B | JO_KEY_C | JO_KEY_START;
+    jo_inputs[0].on_keydown = (jo_inputs[0].pressed ^ previous) & jo_inputs[0].pressed;
+    jo_inputs[0].on_keyup = (previous ^ jo_inputs[0].pressed) & previous;
+    jo_inputs[1].id = PER_ID_StnPad;
+}
+
+/*
+** Callback timing
+*/
+
+static __jo_force_inline void       call_timed(timed_callback * const timed)
+{
+    unsigned long long              start;
+    unsigned long long              elapsed;
+    unsigned int                    malloc_count;
+
+    malloc_count = jo_memory_get_stats()->malloc_count;
+    start = bench_now_ns();
+    if (!run_start_ns)
+        run_start_ns = start;
+    timed->callback();
+    elapsed = bench_now_ns() - start;
+    timed->malloc_count += jo_memory_get_stats()->malloc_count - malloc_count;
+    timed->total_ns += elapsed;
+    if (elapsed > timed->max_ns)
+        timed->max_ns = elapsed;
+    ++timed->calls;
+}
+
+#define TIMED_CALLBACK(N)           static void timed_callback_##N(void) { call_timed(&callbacks[N]); }
+
+TIMED_CALLBACK(0)  TIMED_CALLBACK(1)  TIMED_CALLBACK(2)  TIMED_CALLBACK(3)
+TIMED_CALLBACK(4)  TIMED_CALLBACK(5)  TIMED_CALLBACK(6)  TIMED_CALLBACK(7)
+TIMED_CALLBACK(8)  TIMED_CALLBACK(9)  TIMED_CALLBACK(10) TIMED_CALLBACK(11)
+TIMED_CALLBACK(12) TIMED_CALLBACK(13) TIMED_CALLBACK(14) TIMED_CALLBACK(15)
+
+static const jo_event_callback      timed_callbacks[MAX_CALLBACKS] =
+{
+    timed_callback_0,  timed_callback_1,  timed_callback_2,  timed_callback_3,
+    timed_callback_4,  timed_callback_5,  timed_callback_6,  timed_callback_7,
+    timed_callback_8,  timed_callback_9,  timed_callback_10, timed_callback_11,
+    timed_callback_12, timed_callback_13, timed_callback_14, timed_callback_15,
+};
+
+static int                          add_timed_callback(int (*add)(const jo_event_callback), const jo_event_callback callback, const char * const phase)
+{
+    timed_callback                  *timed;
+
+    BENCH_CHECK(callback_count < MAX_CALLBACKS);
+    timed = &callbacks[callback_count];
+    timed->callback = callback;
+    timed->phase = phase;
+    timed->event_id = add(timed_callbacks[callback_count++]);
+    return (timed->event_id);
+}
+
+int                                 __wrap_jo_core_add_callback(const jo_event_callback callback)
+{
+    return (add_timed_callback(__real_jo_core_add_callback, callback, "render"));
+}
+
+int                                 __wrap_jo_core_add_update_callback(const jo_event_callback callback)
+{
+    return (add_timed_callback(__real_jo_core_add_update_callback, callback, "update"));
+}
+
+/*
+** Report
+*/
+
+/* Static functions (internal engine callbacks) are not exported: their address is printed instead */
+static const char                   *callback_name(const jo_event_callback callback)
+{
+    static char                     address[32];
+    Dl_info                         info;
+
+    if (dladdr((void *)callback, &info) && info.dli_sname != NULL)
+        return (info.dli_sname);
+    snprintf(address, sizeof(address), "%p", (void *)callback);
+    return (address);
+}
+
+static void                         print_report(const unsigned long long startup_ns, const unsigned long long elapsed_ns)
+{
+    const jo_memory_stats           *stats;
+    timed_callback                  *timed;
+    int                             i;
+
+    printf("startup (jo_core_init() and assets): %.1f ms\n", startup_ns / 1e6);
+    printf("%d frames in %.1f ms (%.0f frames per second)\n", frame_count, elapsed_ns / 1e6, frame_count / (elapsed_ns / 1e9));
+    printf("%-20s %-7s %8s %10s %10s %12s\n", "callback", "phase", "calls", "avg us", "max us", "allocs/call");
+    for (i = 0; i < callback_count; ++i)
+    {
+        timed = &callbacks[i];
+        printf("%-20s %-7s %8u %10.2f %10.2f %12.2f\n", callback_name(timed->callback), timed->phase, timed->calls,
+               timed->calls ? timed->total_ns / 1e3 / timed->calls : 0.0, timed->max_ns / 1e3,
+               timed->calls ? (double)timed->malloc_count / timed->calls : 0.0);
+    }
+    stats = jo_memory_get_stats();
+    printf("heap: %u bytes used, %u bytes peak, %u allocations, %u frees\n",
+           stats->used_bytes, stats->peak_used_bytes, stats->malloc_count, stats->free_count);
+}
+
+int                                 __wrap_main(int argc, char **argv)
+{
+    unsigned long long              start;
+    unsigned long long              end;
+
+    if (argc > 1)
+        BENCH_CHECK((frame_count = atoi(argv[1])) > 0);
+    if (argc > 2)
+        load_script(argv[2]);
+    else
+        parse_script(headless_default_script);
+    headless_init_hardware();
+    start = bench_now_ns();
+    __real_main();
+    end = bench_now_ns();
+    BENCH_CHECK(run_start_ns != 0);
+    print_report(run_start_ns - start, end - run_start_ns);
+    BENCH_CHECK(frame == frame_count);
+    return (0);
+}
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,179 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** VDP1 command upload: DMA transfers and bytes sent by jo_vdp1_flush() for 0 to 1200 sprites per frame,
+** with sprites at the same depth, at random depths and at a few depths.
+** VDP1 VRAM is plain memory mapped at its Saturn address, slDMACopy() counts calls and bytes.
+** After each flush, the list is walked like the VDP1 does (jumps, skip assign of the first entry)
+** to check that every sprite is drawn once, farthest first, in creation order at the same depth.
+*/
+
+#include <stdbool.h>
+#include <sys/mman.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/vdp1_command_pipeline.h"
+#include "bench.h"
+
+#define VRAM_SIZE                   (0x80000)
+#define FRAME_COUNT                 (1000)
+#define MAX_WALK_STEPS              (100000)
+
+void                                jo_vdp1_buffer_init(void);
+void                                jo_vdp1_buffer_reset(void);
+void                                jo_vdp1_flush(void);
+
+static unsigned int                 dma_calls;
+static unsigned int                 dma_bytes;
+
+void                                slDMACopy(void *src, void *dst, Uint32 size)
+{
+    ++dma_calls;
+    dma_bytes += size;
+    memcpy(dst, src, size);
+}
+
+void                                slDMAWait(void)
+{
+}
+
+static short                        sprite_depth(const int mode, unsigned int * const seed)
+{
+    switch (mode)
+    {
+    case 0:
+        return (500);
+    case 1:
+        return ((short)(bench_random(seed) % 2000) - 1000);
+    default:
+        return ((short)(bench_random(seed) % 40) + 480);
+    }
+}
+
+static void                         create_sprites(const int count, const int mode, unsigned int * const seed)
+{
+    jo_vdp1_command                 *command;
+    int                             i;
+
+    jo_vdp1_buffer_reset();
+    for (i = 0; i < count; ++i)
+    {
+        command = jo_vdp1_create_command();
+        command->ctrl = DrawNormalSprite;
+        command->xa = i;
+        command->jo_engine_reserved = sprite_depth(mode, seed);
+    }
+}
+
+/* Follow the list displayed from the next frame like the VDP1 */
+static void                         check_displayed_list(const int count)
+{
+    jo_vdp1_command                 *command;
+    unsigned int                    index;
+    int                             seen;
+    int                             steps;
+    int                             last_depth;
+    int                             last_x;
+
+    last_depth = 32767;
+    last_x = -1;
+    for (index = 0, seen = 0, steps = 0; !((command = jo_vdp1_get_command_entry(index))->ctrl & DrawEnd); ++steps)
+    {
+        BENCH_CHECK(steps < MAX_WALK_STEPS);
+        if ((command->ctrl & 0x7000) == 0x5000)
+        {
+            index = command->link / 4;
+            continue;
+        }
+        if ((command->ctrl & 0xF) == DrawNormalSprite)
+        {
+            BENCH_CHECK(command->jo_engine_reserved < last_depth ||
+                        (command->jo_engine_reserved == last_depth && command->xa > last_x));
+            last_depth = command->jo_engine_reserved;
+            last_x = command->xa;
+            ++seen;
+        }
+        index = ((command->ctrl & 0x7000) == 0x1000) ? command->link / 4U : index + 1;
+    }
+    BENCH_CHECK(seen == count);
+}
+
+int                                 main(void)
+{
+    static const int                counts[] = {0, 200, 500, 1000, 1200};
+    static const char * const       modes[] = {"same depth", "random depths", "40 depths"};
+    unsigned long long              start;
+    unsigned long long              best;
+    unsigned long long              elapsed;
+    unsigned int                    seed;
+    unsigned int                    k;
+    int                             mode;
+    int                             frame;
+
+    BENCH_CHECK(mmap((void *)JO_VDP1_VRAM, VRAM_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0) == (void *)JO_VDP1_VRAM);
+    bench_init_memory();
+    jo_vdp1_buffer_init();
+    printf("JO_VDP1_MAX_COMMANDS: %d\n", JO_VDP1_MAX_COMMANDS);
+    printf("%-14s %8s %10s %10s %12s\n", "depths", "sprites", "dma calls", "dma bytes", "flush us");
+    for (mode = 0; mode < 3; ++mode)
+    {
+        for (k = 0; k < sizeof(counts) / sizeof(*counts); ++k)
+        {
+            seed = 1;
+            best = ~0ULL;
+            for (frame = 0; frame < FRAME_COUNT; ++frame)
+            {
+                create_sprites(counts[k], mode, &seed);
+                dma_calls = 0;
+                dma_bytes = 0;
+                start = bench_now_ns();
+                jo_vdp1_flush();
+                elapsed = bench_now_ns() - start;
+                if (elapsed < best)
+                    best = elapsed;
+                /* Both lists */
+                if (frame < 2)
+                    check_displayed_list(counts[k]);
+            }
+            printf("%-14s %8d %10u %10u %12.2f\n", modes[mode], counts[k], dma_calls, dma_bytes, best / 1e3);
+        }
+    }
+    return (0);
+}
+
+/*
+** END OF FILE
+*/
@@ -41,6 +41,7 @@
 #include "jo/sprites.h"
 #include "jo/fs.h"
 #include "jo/math.h"
+#include "jo/pool.h"
 #include "jo/list.h"
 #include "jo/3d.h"
 
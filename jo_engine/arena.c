@@ -0,0 +1,81 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** INCLUDES
+*/
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/arena.h"
+
+jo_arena            __jo_frame_arena;
+
+bool                jo_arena_init(jo_arena * const arena, const unsigned int size_in_bytes)
+{
+    arena->begin = (unsigned char *)jo_malloc_with_behaviour(size_in_bytes, JO_MALLOC_TRY_REUSE_BLOCK);
+    if (arena->begin == JO_NULL)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Out of memory");
+#endif
+        arena->current = JO_NULL;
+        arena->end = JO_NULL;
+        return (false);
+    }
+    arena->current = arena->begin;
+    arena->end = arena->begin + size_in_bytes;
+    return (true);
+}
+
+void                *__jo_frame_arena_first_alloc(const unsigned int n)
+{
+    if (__jo_frame_arena.begin == JO_NULL && !jo_arena_init(&__jo_frame_arena, JO_FRAME_ARENA_SIZE))
+        return (JO_NULL);
+    return jo_arena_alloc(&__jo_frame_arena, n);
+}
+
+void                jo_arena_destroy(jo_arena * const arena)
+{
+    if (arena->begin != JO_NULL)
+        jo_free(arena->begin);
+    arena->begin = JO_NULL;
+    arena->current = JO_NULL;
+    arena->end = JO_NULL;
+}
+
+/*
+** END OF FILE
+*/
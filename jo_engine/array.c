@@ -0,0 +1,140 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** INCLUDES
+*/
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/array.h"
+
+/* Sizes are always a multiple of 4 */
+static  __jo_force_inline void  jo_array_copy(unsigned int *dst, const unsigned int *src, unsigned int size)
+{
+    for (size >>= 2; size; --size)
+        *dst++ = *src++;
+}
+
+bool                jo_array_init(jo_array * const array, unsigned int item_size, const int capacity)
+{
+#ifdef JO_DEBUG
+    if (item_size == 0 || capacity <= 0)
+    {
+        jo_core_error("item_size and capacity must be greater than zero");
+        return (false);
+    }
+#endif
+    while (item_size % 4)
+        ++item_size;
+    array->item_size = item_size;
+    JO_ZERO(array->count);
+    array->allocation_behaviour = JO_MALLOC_TRY_REUSE_BLOCK;
+    array->items = (unsigned char *)jo_malloc_with_behaviour(item_size * capacity, array->allocation_behaviour);
+    if (array->items == JO_NULL)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Out of memory");
+#endif
+        JO_ZERO(array->capacity);
+        return (false);
+    }
+    array->capacity = capacity;
+    return (true);
+}
+
+void                jo_array_destroy(jo_array * const array)
+{
+    if (array->items != JO_NULL)
+        jo_free(array->items);
+    array->items = JO_NULL;
+    JO_ZERO(array->capacity);
+    JO_ZERO(array->count);
+}
+
+bool                __jo_array_grow(jo_array * const array)
+{
+    unsigned char   *items;
+    int             capacity;
+
+    capacity = array->capacity > 0 ? JO_MULT_BY_2(array->capacity) : 4;
+    items = (unsigned char *)jo_malloc_with_behaviour(array->item_size * capacity, array->allocation_behaviour);
+    if (items == JO_NULL)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Out of memory");
+#endif
+        return (false);
+    }
+    if (array->items != JO_NULL)
+    {
+        jo_array_copy((unsigned int *)items, (unsigned int *)array->items, array->item_size * array->count);
+        jo_free(array->items);
+    }
+    array->items = items;
+    array->capacity = capacity;
+    return (true);
+}
+
+void                jo_array_swap_remove(jo_array * const array, const int index)
+{
+#ifdef JO_DEBUG
+    if (index < 0 || index >= array->count)
+    {
+        jo_core_error("Invalid index (%d)", index);
+        return;
+    }
+#endif
+    --array->count;
+    if (index != array->count)
+        jo_array_copy((unsigned int *)jo_array_at(array, index), (unsigned int *)jo_array_at(array, array->count), array->item_size);
+}
+
+void                jo_array_remove(jo_array * const array, const int index)
+{
+#ifdef JO_DEBUG
+    if (index < 0 || index >= array->count)
+    {
+        jo_core_error("Invalid index (%d)", index);
+        return;
+    }
+#endif
+    --array->count;
+    jo_array_copy((unsigned int *)jo_array_at(array, index), (unsigned int *)jo_array_at(array, index + 1), array->item_size * (array->count - index));
+}
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,207 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** INCLUDES
+*/
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/math.h"
+#include "jo/entity.h"
+#include "jo/bullet.h"
+
+/*
+** INTERNAL MACROS
+*/
+/* (8.8 speed * 1.15 direction) >> 7 = 16.16 velocity */
+# define JO_BULLET_VELOCITY(SPEED, DIRECTION)   (((SPEED) * (DIRECTION)) >> 7)
+
+static  __jo_force_inline unsigned int  __jo_bullet_read_word(const unsigned char * const ptr)
+{
+    return ((ptr[0] << 8) | ptr[1]);
+}
+
+/*
+** FIRE
+*/
+
+int                         jo_bullet_fire_radial(jo_entity_store * const bullets, const int x, const int y, const int count, const int speed, const int angle, const int sprite_id)
+{
+    register int            i;
+    int                     a;
+    const int               fixed_x = JO_MULT_BY_65536(x);
+    const int               fixed_y = JO_MULT_BY_65536(y);
+
+    for (JO_ZERO(i); i < count; ++i)
+    {
+        a = angle + (i * 360) / count;
+        if (jo_entity_spawn(bullets, fixed_x, fixed_y, JO_BULLET_VELOCITY(speed, jo_cos(a)), JO_BULLET_VELOCITY(speed, jo_sin(a)), sprite_id) == JO_ENTITY_NONE)
+            return (i);
+    }
+    return (count);
+}
+
+int                         jo_bullet_fire_aimed(jo_entity_store * const bullets, const int x, const int y, const int target_x, const int target_y,
+                                                 const int count, const int speed, const int spread, const int angle, const int sprite_id)
+{
+    register int            i;
+    int                     dx;
+    int                     dy;
+    int                     length;
+    int                     a;
+    int                     cos_a;
+    int                     sin_a;
+    const int               fixed_x = JO_MULT_BY_65536(x);
+    const int               fixed_y = JO_MULT_BY_65536(y);
+
+    dx = target_x - x;
+    dy = target_y - y;
+    /* Keep dx² + dy² in the range of jo_sqrt(), the direction doesn't change */
+    while (JO_ABS(dx) > 255 || JO_ABS(dy) > 255)
+    {
+        dx = JO_DIV_BY_2(dx);
+        dy = JO_DIV_BY_2(dy);
+    }
+    length = (int)jo_sqrt((unsigned int)(dx * dx + dy * dy));
+    if (length == 0)
+    {
+        /* Target on the emitter: shoot down */
+        JO_ZERO(dx);
+        dy = 32767;
+    }
+    else
+    {
+        dx = JO_MULT_BY_32768(dx) / length;
+        dy = JO_MULT_BY_32768(dy) / length;
+    }
+    a = angle - JO_DIV_BY_2((count - 1) * spread);
+    for (JO_ZERO(i); i < count; ++i, a += spread)
+    {
+        cos_a = jo_cos(a);
+        sin_a = jo_sin(a);
+        if (jo_entity_spawn(bullets, fixed_x, fixed_y,
+                            JO_BULLET_VELOCITY(speed, JO_DIV_BY_32768(dx * cos_a - dy * sin_a)),
+                            JO_BULLET_VELOCITY(speed, JO_DIV_BY_32768(dx * sin_a + dy * cos_a)), sprite_id) == JO_ENTITY_NONE)
+            return (i);
+    }
+    return (count);
+}
+
+/*
+** EMITTER
+*/
+
+void                        jo_bullet_emitter_init(jo_bullet_emitter * const emitter, const unsigned char * const script, const int sprite_id)
+{
+#ifdef JO_DEBUG
+    if (script == JO_NULL)
+    {
+        jo_core_error("script is null");
+        return;
+    }
+#endif
+    JO_ZERO(emitter->x);
+    JO_ZERO(emitter->y);
+    emitter->sprite_id = sprite_id;
+    emitter->script = script;
+    jo_bullet_emitter_restart(emitter);
+}
+
+bool                        jo_bullet_emitter_update(jo_bullet_emitter * const emitter, jo_entity_store * const bullets, const int target_x, const int target_y)
+{
+    const unsigned char     *instruction;
+    register int            step;
+    int                     phase_angle;
+
+    if (emitter->wait > 0 && --emitter->wait > 0)
+        return (true);
+    for (JO_ZERO(step); step < JO_BULLET_SCRIPT_MAX_STEPS; ++step)
+    {
+        instruction = emitter->script + emitter->pc * JO_BULLET_INSTRUCTION_SIZE;
+        switch (instruction[0])
+        {
+            case JO_BULLET_OP_END:
+                return (false);
+            case JO_BULLET_OP_WAIT:
+                emitter->wait = __jo_bullet_read_word(instruction + 4);
+                ++emitter->pc;
+                if (emitter->wait > 0)
+                    return (true);
+                break;
+            case JO_BULLET_OP_LOOP:
+                if (instruction[1] == 0 || ++emitter->loop_count < instruction[1])
+                    emitter->pc = __jo_bullet_read_word(instruction + 4);
+                else
+                {
+                    JO_ZERO(emitter->loop_count);
+                    ++emitter->pc;
+                }
+                break;
+            case JO_BULLET_OP_RADIAL:
+                jo_bullet_fire_radial(bullets, emitter->x, emitter->y, instruction[1], __jo_bullet_read_word(instruction + 4),
+                                      (short)__jo_bullet_read_word(instruction + 6), emitter->sprite_id);
+                ++emitter->pc;
+                break;
+            case JO_BULLET_OP_AIMED:
+                jo_bullet_fire_aimed(bullets, emitter->x, emitter->y, target_x, target_y, instruction[1], __jo_bullet_read_word(instruction + 4),
+                                     instruction[2], (short)__jo_bullet_read_word(instruction + 6), emitter->sprite_id);
+                ++emitter->pc;
+                break;
+            case JO_BULLET_OP_SPIRAL:
+                jo_bullet_fire_radial(bullets, emitter->x, emitter->y, instruction[1], __jo_bullet_read_word(instruction + 4),
+                                      (short)__jo_bullet_read_word(instruction + 6) + emitter->phase, emitter->sprite_id);
+                emitter->phase = (emitter->phase + (signed char)instruction[2]) % 360;
+                ++emitter->pc;
+                break;
+            case JO_BULLET_OP_WAVE:
+                phase_angle = JO_DIV_BY_32768(instruction[3] * jo_sin(emitter->phase));
+                jo_bullet_fire_radial(bullets, emitter->x, emitter->y, instruction[1], __jo_bullet_read_word(instruction + 4),
+                                      (short)__jo_bullet_read_word(instruction + 6) + phase_angle, emitter->sprite_id);
+                emitter->phase = (emitter->phase + (signed char)instruction[2]) % 360;
+                ++emitter->pc;
+                break;
+            default:
+#ifdef JO_DEBUG
+                jo_core_error("Invalid bullet script operation (%d)", (int)instruction[0]);
+#endif
+                return (false);
+        }
+    }
+    /* Loop without wait: resume on next frame */
+    return (true);
+}
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,333 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** INCLUDES
+*/
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/collision.h"
+
+/*
+** GRID
+*/
+
+bool                    jo_collision_grid_init(jo_collision_grid * const grid, const int left, const int top, const int width, const int height,
+                                               const int max_objects, const int max_entries)
+{
+    unsigned char       *storage;
+    int                 cell_count;
+
+#ifdef JO_DEBUG
+    if (width <= 0 || height <= 0 || max_objects <= 0 || max_objects > 0x7FFF || max_entries <= 0 || max_entries > 0x7FFF)
+    {
+        jo_core_error("Invalid grid size");
+        return (false);
+    }
+#endif
+    grid->left = left;
+    grid->top = top;
+    grid->columns = ((width - 1) >> JO_COLLISION_GRID_CELL_SHIFT) + 1;
+    grid->rows = ((height - 1) >> JO_COLLISION_GRID_CELL_SHIFT) + 1;
+    cell_count = grid->columns * grid->rows;
+    /* One block: boxes, ids then short arrays */
+    storage = (unsigned char *)jo_malloc_with_behaviour(max_objects * (sizeof(jo_aabb) + sizeof(int) + sizeof(unsigned short)) +
+                                                        (cell_count + JO_MULT_BY_2(max_entries)) * sizeof(short), JO_MALLOC_TRY_REUSE_BLOCK);
+    if (storage == JO_NULL)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Out of memory");
+#endif
+        JO_ZERO(grid->max_objects);
+        JO_ZERO(grid->max_entries);
+        return (false);
+    }
+    grid->max_objects = max_objects;
+    grid->max_entries = max_entries;
+    grid->boxes = (jo_aabb *)storage;
+    grid->ids = (int *)(grid->boxes + max_objects);
+    grid->stamps = (unsigned short *)(grid->ids + max_objects);
+    grid->cells = (short *)(grid->stamps + max_objects);
+    grid->entry_next = grid->cells + cell_count;
+    grid->entry_object = grid->entry_next + max_entries;
+    JO_ZERO(grid->stamp);
+    jo_memset(grid->stamps, 0, max_objects * sizeof(unsigned short));
+    jo_collision_grid_clear(grid);
+    return (true);
+}
+
+void                    jo_collision_grid_destroy(jo_collision_grid * const grid)
+{
+    if (grid->max_objects > 0)
+        jo_free(grid->boxes);
+    grid->boxes = JO_NULL;
+    JO_ZERO(grid->max_objects);
+    JO_ZERO(grid->max_entries);
+    JO_ZERO(grid->object_count);
+    JO_ZERO(grid->entry_count);
+}
+
+void                    jo_collision_grid_clear(jo_collision_grid * const grid)
+{
+    register short      *cell;
+    short               *end;
+
+    end = grid->cells + grid->columns * grid->rows;
+    for (cell = grid->cells; cell < end; ++cell)
+        *cell = -1;
+    JO_ZERO(grid->object_count);
+    JO_ZERO(grid->entry_count);
+}
+
+static  __jo_force_inline int   jo_collision_grid_column(const jo_collision_grid * const grid, const int x)
+{
+    int                         column;
+
+    column = (x - grid->left) >> JO_COLLISION_GRID_CELL_SHIFT;
+    if (column < 0)
+        return (0);
+    if (column >= grid->columns)
+        return (grid->columns - 1);
+    return (column);
+}
+
+static  __jo_force_inline int   jo_collision_grid_row(const jo_collision_grid * const grid, const int y)
+{
+    int                         row;
+
+    row = (y - grid->top) >> JO_COLLISION_GRID_CELL_SHIFT;
+    if (row < 0)
+        return (0);
+    if (row >= grid->rows)
+        return (grid->rows - 1);
+    return (row);
+}
+
+bool                    jo_collision_grid_add(jo_collision_grid * const grid, const jo_aabb * const box, const int id)
+{
+    int                 object;
+    int                 column;
+    int                 row;
+    int                 first_column;
+    int                 last_column;
+    int                 last_row;
+    short               *cell;
+
+    if (grid->object_count >= grid->max_objects)
+        return (false);
+    first_column = jo_collision_grid_column(grid, box->x);
+    last_column = jo_collision_grid_column(grid, box->x + box->width - 1);
+    row = jo_collision_grid_row(grid, box->y);
+    last_row = jo_collision_grid_row(grid, box->y + box->height - 1);
+    if (grid->entry_count + (last_column - first_column + 1) * (last_row - row + 1) > grid->max_entries)
+        return (false);
+    object = grid->object_count++;
+    grid->boxes[object] = *box;
+    grid->ids[object] = id;
+    for (; row <= last_row; ++row)
+    {
+        cell = grid->cells + row * grid->columns + first_column;
+        for (column = first_column; column <= last_column; ++column, ++cell)
+        {
+            grid->entry_object[grid->entry_count] = object;
+            grid->entry_next[grid->entry_count] = *cell;
+            *cell = grid->entry_count++;
+        }
+    }
+    return (true);
+}
+
+void                    jo_collision_grid_build(jo_collision_grid * const grid, const jo_aabb * const boxes, const int count)
+{
+    int                 i;
+
+    jo_collision_grid_clear(grid);
+    for (JO_ZERO(i); i < count; ++i)
+        if (!jo_collision_grid_add(grid, boxes + i, i))
+        {
+#ifdef JO_DEBUG
+            jo_core_error("Grid is full");
+#endif
+            return;
+        }
+}
+
+bool                    jo_collision_grid_query(jo_collision_grid * const grid, const jo_aabb * const box, jo_collision_callback callback, void *extra)
+{
+    int                 column;
+    int                 row;
+    int                 first_column;
+    int                 last_column;
+    int                 last_row;
+    int                 entry;
+    int                 object;
+
+    /* Stamps make sure an object that spans several cells is reported once */
+    if (++grid->stamp == 0)
+    {
+        jo_memset(grid->stamps, 0, grid->max_objects * sizeof(unsigned short));
+        grid->stamp = 1;
+    }
+    first_column = jo_collision_grid_column(grid, box->x);
+    last_column = jo_collision_grid_column(grid, box->x + box->width - 1);
+    row = jo_collision_grid_row(grid, box->y);
+    last_row = jo_collision_grid_row(grid, box->y + box->height - 1);
+    for (; row <= last_row; ++row)
+        for (column = first_column; column <= last_column; ++column)
+            for (entry = grid->cells[row * grid->columns + column]; entry >= 0; entry = grid->entry_next[entry])
+            {
+                object = grid->entry_object[entry];
+                if (grid->stamps[object] == grid->stamp)
+                    continue;
+                grid->stamps[object] = grid->stamp;
+                if (jo_aabb_intersect(box, grid->boxes + object) && callback(grid->ids[object], extra))
+                    return (true);
+            }
+    return (false);
+}
+
+/*
+** SWEEP AND PRUNE
+*/
+
+bool                    jo_collision_sap_init(jo_collision_sap * const sap, const int capacity)
+{
+#ifdef JO_DEBUG
+    if (capacity <= 0 || capacity > 0xFFFF)
+    {
+        jo_core_error("Invalid capacity (%d)", capacity);
+        return (false);
+    }
+#endif
+    JO_ZERO(sap->count);
+    sap->order = (unsigned short *)jo_malloc_with_behaviour(capacity * (sizeof(unsigned short) + sizeof(short)), JO_MALLOC_TRY_REUSE_BLOCK);
+    if (sap->order == JO_NULL)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Out of memory");
+#endif
+        JO_ZERO(sap->capacity);
+        return (false);
+    }
+    sap->capacity = capacity;
+    sap->keys = (short *)(sap->order + capacity);
+    return (true);
+}
+
+void                    jo_collision_sap_destroy(jo_collision_sap * const sap)
+{
+    if (sap->capacity > 0)
+        jo_free(sap->order);
+    sap->order = JO_NULL;
+    sap->keys = JO_NULL;
+    JO_ZERO(sap->capacity);
+    JO_ZERO(sap->count);
+}
+
+static void             jo_collision_sap_resize(jo_collision_sap * const sap, const int count)
+{
+    int                 i;
+    int                 kept;
+
+    /* Drop indexes that no longer exist then append the new ones */
+    for (JO_ZERO(i), JO_ZERO(kept); i < sap->count; ++i)
+        if (sap->order[i] < count)
+            sap->order[kept++] = sap->order[i];
+    for (i = sap->count; i < count; ++i)
+        sap->order[kept++] = i;
+    sap->count = count;
+}
+
+void                    jo_collision_sap_find_pairs(jo_collision_sap * const sap, const jo_aabb * const boxes, const int count,
+                                                    jo_collision_pair_callback callback, void *extra)
+{
+    register int        i;
+    register int        j;
+    unsigned short      index;
+    short               key;
+    int                 bottom;
+    const jo_aabb       *box;
+    const jo_aabb       *other;
+
+#ifdef JO_DEBUG
+    if (count > sap->capacity)
+    {
+        jo_core_error("Too many boxes (%d)", count);
+        return;
+    }
+#endif
+    if (count != sap->count)
+        jo_collision_sap_resize(sap, count);
+    for (JO_ZERO(i); i < count; ++i)
+        sap->keys[i] = boxes[sap->order[i]].y;
+    /* Insertion sort: O(n) when the order barely changes between frames */
+    for (i = 1; i < count; ++i)
+    {
+        key = sap->keys[i];
+        index = sap->order[i];
+        for (j = i - 1; j >= 0 && sap->keys[j] > key; --j)
+        {
+            sap->keys[j + 1] = sap->keys[j];
+            sap->order[j + 1] = sap->order[j];
+        }
+        sap->keys[j + 1] = key;
+        sap->order[j + 1] = index;
+    }
+    for (JO_ZERO(i); i < count; ++i)
+    {
+        box = boxes + sap->order[i];
+        if (box->width <= 0 || box->height <= 0)
+            continue;
+        bottom = box->y + box->height;
+        for (j = i + 1; j < count && sap->keys[j] < bottom; ++j)
+        {
+            other = boxes + sap->order[j];
+            if (other->width <= 0 || other->height <= 0)
+                continue;
+            if (box->x < other->x + other->width && other->x < box->x + box->width)
+            {
+                if (sap->order[i] < sap->order[j])
+                    callback(sap->order[i], sap->order[j], extra);
+                else
+                    callback(sap->order[j], sap->order[i], extra);
+            }
+        }
+    }
+}
+
+/*
+** END OF FILE
+*/
@@ -45,10 +45,16 @@
 #include "jo/sprites.h"
 #include "jo/input.h"
 #include "jo/malloc.h"
+#include "jo/arena.h"
+#include "jo/handle.h"
 #include "jo/video.h"
+#include "jo/pool.h"
 #include "jo/list.h"
+#include "jo/array.h"
 #include "jo/background.h"
 #include "jo/storyboard.h"
+#include "jo/backup.h"
+#include "jo/replay.h"
 
 /*
 ** INTERNAL MACROS
@@ -58,6 +64,10 @@
 # define IPRB ((unsigned short *)0xfffffe60)
 # define TIER ((unsigned char *)0xfffffe10)
 # define FTCSR ((unsigned char *)0xfffffe11)
+/* Bytes cleared between two VBLANK status checks (see jo_memory_zero_fill_step()) */
+# define JO_ZERO_FILL_STEP (1024)
+/* Initial size of the game loop callback arrays (they grow if needed) */
+# define JO_CORE_CALLBACK_CAPACITY (8)
 
 /*
 ** DEFINITIONS
@@ -73,7 +83,7 @@ extern unsigned int                         _bend;
 extern void                                 jo_main(void);
 
 #ifdef JO_COMPILE_WITH_STORYBOARD_SUPPORT
-extern jo_list                              __storyboards;
+extern jo_intrusive_list                    __storyboards;
 void                                        jo_execute_storyboards(void);
 void                                        jo_init_storyboards(void);
 #endif
@@ -90,21 +100,39 @@ void                                        jo_vdp1_buffer_init(void);
 void                                        jo_vdp1_buffer_reset(void);
 void                                        jo_vdp1_flush(void);
 void                                        jo_input_update(void);
+void                                        jo_input_clear_events(void);
 void                                        jo_input_init(void);
 #ifdef JO_COMPILE_WITH_FS_SUPPORT
 int						                    jo_fs_init(void);
 #endif
 void                                        jo_fs_do_background_jobs(void);
-void                                        jo_add_memory_zone(unsigned char *ptr, const unsigned int size_in_bytes);
+void                                        jo_add_memory_zone(unsigned char *ptr, const unsigned int size_in_bytes, const bool is_zeroed);
 void                                        jo_sprite_init(void);
 void                                        jo_time_init(unsigned char mode);
 
 #ifdef JO_DEBUG
 char                                        __jo_last_error[JO_PRINTF_BUF_SIZE];
+static unsigned int                         __jo_memory_init_ticks;
 #endif
 
-static jo_list                             __callbacks;
-static jo_list                             __slave_callbacks;
+/** @brief Game loop callback, a removed callback is NULL until the end of the frame */
+typedef struct
+{
+    int                                     event_id;
+    jo_event_callback                       callback;
+#ifdef JO_DEBUG
+    jo_core_callback_profile                profile;
+#endif
+}                                           __jo_core_callback;
+
+static jo_array                            __callbacks;
+static jo_array                            __slave_callbacks;
+static jo_array                            __update_callbacks;
+/* Fixed timestep mode: FRC ticks of a frame (0 until calibrated) and update steps of the current frame */
+static unsigned int                         __jo_frame_ticks;
+static int                                  __jo_update_steps = 1;
+static int                                  __jo_last_event_id;
+static int                                  __jo_removed_callback_count;
 
 static __jo_force_inline void jo_wait_vblank_out(void)
 {
@@ -113,9 +141,24 @@ static __jo_force_inline void jo_wait_vblank_out(void)
 
 static __jo_force_inline void jo_wait_vblank_in(void)
 {
+    /* Use the idle time to clear memory zones */
+    while ((JO_VDP2_TVSTAT & 8) == 0 && jo_memory_zero_fill_step(JO_ZERO_FILL_STEP));
     while ((JO_VDP2_TVSTAT & 8) == 0);
 }
 
+#if JO_COMPILE_USING_SGL
+
+/* slSynch() gives no idle time: memory zones are cleared before it, in the same slices,
+** only while the frame is ahead of schedule (the last quarter is left to slSynch() itself)
+*/
+static __jo_force_inline void jo_zero_fill_spare_frame_time(void)
+{
+    while ((*FTCSR & JO_TIME_OVF) == 0 && (unsigned int)jo_time_get_frc() < __jo_frame_ticks - JO_DIV_BY_4(__jo_frame_ticks) &&
+           jo_memory_zero_fill_step(JO_ZERO_FILL_STEP));
+}
+
+#endif
+
 #ifdef JO_COMPILE_WITH_RAM_CARD_SUPPORT
 
 static  __jo_force_inline void              jo_enable_extended_ram_cartridge_support(void)
@@ -135,26 +178,27 @@ static void                 jo_init_memory(void)
 {
     static unsigned char    global_memory[JO_GLOBAL_MEMORY_SIZE_FOR_MALLOC];
 
-    jo_add_memory_zone(global_memory, sizeof(global_memory));
+    /* global_memory is in the BSS section cleared by main() */
+    jo_add_memory_zone(global_memory, sizeof(global_memory), true);
 #ifdef JO_COMPILE_WITH_RAM_CARD_SUPPORT
     if (jo_get_extended_ram_cartridge_type() == CART_8MBits)
     {
         jo_enable_extended_ram_cartridge_support();
         jo_set_a_bus_register();
-        jo_add_memory_zone((unsigned char *)0x2247ffff, 0x180000);
-        jo_add_memory_zone((unsigned char *)0x2267ffff, 0x180000);
+        jo_add_memory_zone((unsigned char *)0x2247ffff, 0x180000, false);
+        jo_add_memory_zone((unsigned char *)0x2267ffff, 0x180000, false);
     }
     else if (jo_get_extended_ram_cartridge_type() == CART_32MBits)
     {
         jo_enable_extended_ram_cartridge_support();
         jo_set_a_bus_register();
-        jo_add_memory_zone((unsigned char *)0x2247ffff, 0x180000);
-        jo_add_memory_zone((unsigned char *)0x2267ffff, 0x180000);
-        jo_add_memory_zone((unsigned char *)0x2287ffff, 0x180000);
-        jo_add_memory_zone((unsigned char *)0x22a7ffff, 0x180000);
-        jo_add_memory_zone((unsigned char *)0x22c7ffff, 0x180000);
-        jo_add_memory_zone((unsigned char *)0x22e7ffff, 0x180000);
-        jo_add_memory_zone((unsigned char *)0x2307ffff, 0x180000);
+        jo_add_memory_zone((unsigned char *)0x2247ffff, 0x180000, false);
+        jo_add_memory_zone((unsigned char *)0x2267ffff, 0x180000, false);
+        jo_add_memory_zone((unsigned char *)0x2287ffff, 0x180000, false);
+        jo_add_memory_zone((unsigned char *)0x22a7ffff, 0x180000, false);
+        jo_add_memory_zone((unsigned char *)0x22c7ffff, 0x180000, false);
+        jo_add_memory_zone((unsigned char *)0x22e7ffff, 0x180000, false);
+        jo_add_memory_zone((unsigned char *)0x2307ffff, 0x180000, false);
     }
 #endif
 }
@@ -285,16 +329,56 @@ static	void	jo_core_init_vdp(const jo_color back_color)
 #endif
 }
 
-static __jo_force_inline void __jo_call_event(jo_node *node)
+static void                 __jo_call_event(void *item)
+{
+    if (((__jo_core_callback *)item)->callback != JO_NULL)
+        ((__jo_core_callback *)item)->callback();
+}
+
+#ifdef JO_DEBUG
+
+/* Main CPU only: the FRC of the slave CPU is used to wake it up */
+static void                 __jo_call_event_with_profiling(void *item)
+{
+    __jo_core_callback      *event;
+    unsigned int            start_ticks;
+    unsigned int            malloc_count;
+
+    event = (__jo_core_callback *)item;
+    if (event->callback == JO_NULL)
+        return;
+    malloc_count = jo_memory_get_stats()->malloc_count;
+    start_ticks = jo_time_get_frc();
+    event->callback();
+    /* Only reset by the fixed timestep mode between two callbacks, unless the callback calls jo_get_ticks() */
+    event->profile.last_cycles = ((jo_time_get_frc() - start_ticks) & 0xFFFF) * jo_time_get_frc_cycles_per_tick();
+    event->profile.total_cycles += event->profile.last_cycles;
+    event->profile.malloc_count += jo_memory_get_stats()->malloc_count - malloc_count;
+    ++event->profile.calls;
+}
+
+# define __jo_call_main_event       __jo_call_event_with_profiling
+
+#else
+
+# define __jo_call_main_event       __jo_call_event
+
+#endif
+
+static void                 __jo_remove_dead_callbacks(jo_array * const callbacks)
 {
-    ((jo_event_callback)node->data.ptr)();
+    int                     i;
+
+    for (i = callbacks->count - 1; i >= 0; --i)
+        if (((__jo_core_callback *)jo_array_at(callbacks, i))->callback == JO_NULL)
+            jo_array_remove(callbacks, i);
 }
 
 #ifdef JO_COMPILE_WITH_DUAL_CPU_SUPPORT
 
 static void jo_slave_callbacks(void)
 {
-    jo_list_foreach(&__slave_callbacks, __jo_call_event);
+    jo_array_foreach(&__slave_callbacks, __jo_call_event);
 }
 
 #if JO_COMPILE_USING_SGL
@@ -411,10 +495,16 @@ void			jo_core_init(const jo_color back_color)
 {
 #ifdef JO_DEBUG
     JO_ZERO(__jo_last_error[0]);
+    jo_time_init(JO_TIME_CKS_128_MODE);
+    *FTCSR &= ~JO_TIME_OVF;
 #endif
     jo_init_memory();
-    jo_list_init(&__callbacks);
-    jo_list_init(&__slave_callbacks);
+#ifdef JO_DEBUG
+    __jo_memory_init_ticks = (*FTCSR & JO_TIME_OVF) ? 0xFFFF : jo_time_get_frc();
+#endif
+    jo_array_init_for_type(&__callbacks, __jo_core_callback, JO_CORE_CALLBACK_CAPACITY);
+    jo_array_init_for_type(&__slave_callbacks, __jo_core_callback, JO_CORE_CALLBACK_CAPACITY);
+    jo_array_init_for_type(&__update_callbacks, __jo_core_callback, JO_CORE_CALLBACK_CAPACITY);
 #ifdef JO_COMPILE_WITH_DUAL_CPU_SUPPORT
     jo_core_slave_init();
 #endif
@@ -462,9 +552,9 @@ void			jo_core_init(const jo_color back_color)
     jo_time_init(JO_TIME_CKS_32_MODE);
 }
 
-inline int			jo_core_add_callback(const jo_event_callback callback)
+static int                  __jo_core_add_callback(jo_array * const callbacks, const jo_event_callback callback)
 {
-    jo_node         *node;
+    __jo_core_callback      *item;
 
 #ifdef JO_DEBUG
     if (callback == JO_NULL)
@@ -473,14 +563,22 @@ inline int			jo_core_add_callback(const jo_event_callback callback)
         return (0);
     }
 #endif
-    node = jo_list_add_ptr(&__callbacks, callback);
-    if (node == JO_NULL)
+    item = (__jo_core_callback *)jo_array_push(callbacks);
+    if (item == JO_NULL)
         return (0);
-    return (int)node;
+#ifdef JO_DEBUG
+    jo_memset(&item->profile, 0, sizeof(item->profile));
+#endif
+    item->event_id = ++__jo_last_event_id;
+    item->callback = callback;
+    return (item->event_id);
 }
 
-inline void    jo_core_remove_callback(const int event_id)
+static void                 __jo_core_remove_callback(jo_array * const callbacks, const int event_id)
 {
+    int                     i;
+    __jo_core_callback      *item;
+
 #ifdef JO_DEBUG
     if (event_id == 0)
     {
@@ -488,36 +586,52 @@ inline void    jo_core_remove_callback(const int event_id)
         return;
     }
 #endif
-    jo_list_remove(&__callbacks, (jo_node *)event_id);
+    /* The callback may be running, so it is only disabled here and removed by jo_core_run() */
+    for (JO_ZERO(i); i < callbacks->count; ++i)
+    {
+        item = (__jo_core_callback *)jo_array_at(callbacks, i);
+        if (item->event_id == event_id && item->callback != JO_NULL)
+        {
+            item->callback = JO_NULL;
+            ++__jo_removed_callback_count;
+            return;
+        }
+    }
 }
 
-inline int			jo_core_add_slave_callback(const jo_event_callback callback)
+inline int			jo_core_add_callback(const jo_event_callback callback)
 {
-    jo_node         *node;
+    return (__jo_core_add_callback(&__callbacks, callback));
+}
 
-#ifdef JO_DEBUG
-    if (callback == JO_NULL)
-    {
-        jo_core_error("callback is null");
-        return (0);
-    }
-#endif
-    node = jo_list_add_ptr(&__slave_callbacks, callback);
-    if (node == JO_NULL)
-        return (0);
-    return (int)node;
+inline void    jo_core_remove_callback(const int event_id)
+{
+    __jo_core_remove_callback(&__callbacks, event_id);
+}
+
+inline int			jo_core_add_update_callback(const jo_event_callback callback)
+{
+    return (__jo_core_add_callback(&__update_callbacks, callback));
+}
+
+inline void    jo_core_remove_update_callback(const int event_id)
+{
+    __jo_core_remove_callback(&__update_callbacks, event_id);
+}
+
+inline int          jo_core_get_update_steps(void)
+{
+    return (__jo_update_steps);
+}
+
+inline int			jo_core_add_slave_callback(const jo_event_callback callback)
+{
+    return (__jo_core_add_callback(&__slave_callbacks, callback));
 }
 
 inline void    jo_core_remove_slave_callback(const int event_id)
 {
-#ifdef JO_DEBUG
-    if (event_id == 0)
-    {
-        jo_core_error("Invalid event_id (%d)", event_id);
-        return;
-    }
-#endif
-    jo_list_remove(&__slave_callbacks, (jo_node *)event_id);
+    __jo_core_remove_callback(&__slave_callbacks, event_id);
 }
 
 void            jo_goto_boot_menu(void)
@@ -603,10 +717,79 @@ void            jo_core_suspend(void)
     }
 }
 
+/*
+** FIXED TIMESTEP
+*/
+
+static void                 __jo_core_calibrate_frame_ticks(void)
+{
+    jo_time_init(JO_TIME_CKS_128_MODE);
+    jo_wait_vblank_out();
+    jo_wait_vblank_in();
+    jo_time_set_frc(0);
+    jo_wait_vblank_out();
+    jo_wait_vblank_in();
+    __jo_frame_ticks = jo_time_get_frc();
+#if JO_COMPILE_USING_SGL
+    /* slSynch() waits JO_FRAMERATE vertical blanks */
+    __jo_frame_ticks *= JO_FRAMERATE;
+#endif
+    *FTCSR &= ~JO_TIME_OVF;
+    jo_time_set_frc(0);
+}
+
+/* Called right after the vertical blank sync: frames elapsed since the previous sync become the update steps of the next frame */
+static void                 __jo_core_measure_update_steps(void)
+{
+    unsigned int            ticks;
+
+    if (*FTCSR & JO_TIME_OVF)
+    {
+        *FTCSR &= ~JO_TIME_OVF;
+        __jo_update_steps = JO_CORE_MAX_UPDATE_STEPS;
+    }
+    else
+    {
+        ticks = jo_time_get_frc();
+        __jo_update_steps = (ticks + JO_DIV_BY_2(__jo_frame_ticks)) / __jo_frame_ticks;
+        /* Recorded and replayed inputs are per frame: lockstep */
+        if (__jo_update_steps < 1 || __jo_replay != JO_NULL)
+            __jo_update_steps = 1;
+        else if (__jo_update_steps > JO_CORE_MAX_UPDATE_STEPS)
+            __jo_update_steps = JO_CORE_MAX_UPDATE_STEPS;
+    }
+    jo_time_set_frc(0);
+}
+
+static void                 __jo_core_update(void)
+{
+    register int            step;
+
+    for (JO_ZERO(step); step < __jo_update_steps; ++step)
+    {
+        /* Key down/up events belong to the first step only (the render phase still sees them when a single step runs) */
+        if (step > 0)
+            jo_input_clear_events();
+#ifdef JO_COMPILE_WITH_STORYBOARD_SUPPORT
+        if (__storyboards.count)
+            jo_execute_storyboards();
+#endif
+        jo_array_foreach(&__update_callbacks, __jo_call_main_event);
+    }
+}
+
 void			        jo_core_run(void)
 {
     for (;;)
     {
+#if JO_COMPILE_USING_SGL
+        /* The frame budget also tells how much memory can be cleared (see jo_zero_fill_spare_frame_time()) */
+        if (!__jo_frame_ticks && (__update_callbacks.count || jo_memory_zero_fill_pending_bytes()))
+#else
+        if (__update_callbacks.count && !__jo_frame_ticks)
+#endif
+            __jo_core_calibrate_frame_ticks();
+        jo_arena_reset(&__jo_frame_arena);
 #if !JO_COMPILE_USING_SGL
         jo_vdp1_buffer_reset();
 #endif
@@ -620,7 +803,7 @@ void			        jo_core_run(void)
 #endif
 
 #ifdef JO_COMPILE_WITH_STORYBOARD_SUPPORT
-        if (__storyboards.count)
+        if (__storyboards.count && !__update_callbacks.count)
             jo_execute_storyboards();
 #endif
 
@@ -628,7 +811,7 @@ void			        jo_core_run(void)
         if (__slave_callbacks.count)
             jo_core_exec_on_slave(jo_slave_callbacks);
 #else
-        jo_list_foreach(&__slave_callbacks, __jo_call_event);
+        jo_array_foreach(&__slave_callbacks, __jo_call_event);
 #endif
         if (jo_is_pad1_available() && jo_is_pad1_key_pressed(JO_KEY_A) && jo_is_pad1_key_pressed(JO_KEY_B) &&
                 jo_is_pad1_key_pressed(JO_KEY_C) && jo_is_pad1_key_pressed(JO_KEY_START))
@@ -637,20 +820,38 @@ void			        jo_core_run(void)
         if (__jo_fs_background_job_count)
             jo_fs_do_background_jobs();
 #endif
-        jo_list_foreach(&__callbacks, __jo_call_event);
+        if (__update_callbacks.count)
+            __jo_core_update();
+        jo_array_foreach(&__callbacks, __jo_call_main_event);
 #ifdef JO_COMPILE_WITH_DUAL_CPU_SUPPORT
         if (__slave_callbacks.count)
             jo_core_wait_for_slave();
 #endif
+        if (__jo_removed_callback_count)
+        {
+            __jo_remove_dead_callbacks(&__callbacks);
+            __jo_remove_dead_callbacks(&__slave_callbacks);
+            __jo_remove_dead_callbacks(&__update_callbacks);
+            JO_ZERO(__jo_removed_callback_count);
+        }
 
+        jo_handle_compact_step(JO_HANDLE_COMPACTION_BUDGET);
 #if JO_COMPILE_USING_SGL
+        __jo_sprite_draw_retained();
+        if (__jo_frame_ticks)
+            jo_zero_fill_spare_frame_time();
         slSynch();
 #else
+        /* Uploads to the command list the VDP1 is not drawing, it is displayed from the next frame change */
         jo_vdp1_flush();
         jo_wait_vblank_out();
         jo_wait_vblank_in();
         jo_input_update();
 #endif
+        if (__jo_replay != JO_NULL)
+            jo_replay_update();
+        if (__jo_frame_ticks)
+            __jo_core_measure_update_steps();
         __jo_gouraud_shading_runtime_index = -1;
     }
     jo_goto_boot_menu();
@@ -658,6 +859,56 @@ void			        jo_core_run(void)
 
 #ifdef JO_DEBUG
 
+unsigned int        jo_core_get_memory_init_ticks(void)
+{
+    return (__jo_memory_init_ticks);
+}
+
+static __jo_core_callback   *__jo_core_find_callback(jo_array * const callbacks, const int event_id)
+{
+    __jo_core_callback      *item;
+    int                     i;
+
+    for (JO_ZERO(i); i < callbacks->count; ++i)
+    {
+        item = (__jo_core_callback *)jo_array_at(callbacks, i);
+        if (item->event_id == event_id && item->callback != JO_NULL)
+            return (item);
+    }
+    return (JO_NULL);
+}
+
+const jo_core_callback_profile  *jo_core_get_callback_profile(const int event_id)
+{
+    __jo_core_callback      *item;
+
+    if ((item = __jo_core_find_callback(&__update_callbacks, event_id)) == JO_NULL &&
+        (item = __jo_core_find_callback(&__callbacks, event_id)) == JO_NULL)
+        return (JO_NULL);
+    return (&item->profile);
+}
+
+static int                  __jo_core_print_callback_profiles(jo_array * const callbacks, const int x, int y)
+{
+    __jo_core_callback      *item;
+    int                     i;
+
+    for (JO_ZERO(i); i < callbacks->count; ++i)
+    {
+        item = (__jo_core_callback *)jo_array_at(callbacks, i);
+        if (item->callback == JO_NULL || item->profile.calls == 0)
+            continue;
+        jo_printf(x, y++, "#%d: %d cycles %d allocs  ", item->event_id,
+                  (int)(item->profile.total_cycles / item->profile.calls), (int)(item->profile.malloc_count / item->profile.calls));
+    }
+    return (y);
+}
+
+void                jo_core_print_callback_profiles(const int x, const int y)
+{
+    __jo_core_print_callback_profiles(&__callbacks, x, __jo_core_print_callback_profiles(&__update_callbacks, x, y));
+}
+
 void                jo_dump_vdp1_registers(void)
 {
     unsigned short  *ptr;
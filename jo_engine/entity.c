@@ -0,0 +1,252 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** INCLUDES
+*/
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/entity.h"
+
+bool                    jo_entity_store_init(jo_entity_store * const store, const int capacity)
+{
+    unsigned char       *storage;
+    int                 words;
+
+#ifdef JO_DEBUG
+    if (capacity <= 0 || capacity > 0xFFFF)
+    {
+        jo_core_error("Invalid capacity (%d)", capacity);
+        return (false);
+    }
+#endif
+    words = JO_DIV_BY_32(capacity + 31);
+    /* One block: 4 int arrays, the alive bitmask then 3 short arrays */
+    storage = (unsigned char *)jo_malloc_with_behaviour(JO_MULT_BY_16(capacity) + JO_MULT_BY_4(words) + ((capacity * 6 + 3) & ~3), JO_MALLOC_TRY_REUSE_BLOCK);
+    if (storage == JO_NULL)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Out of memory");
+#endif
+        JO_ZERO(store->capacity);
+        JO_ZERO(store->count);
+        JO_ZERO(store->free_count);
+        return (false);
+    }
+    store->capacity = capacity;
+    store->x = (int *)storage;
+    store->y = store->x + capacity;
+    store->vx = store->y + capacity;
+    store->vy = store->vx + capacity;
+    store->alive = (unsigned int *)(store->vy + capacity);
+    store->sprite = (short *)(store->alive + words);
+    store->hp = store->sprite + capacity;
+    store->free_slots = (unsigned short *)(store->hp + capacity);
+    jo_entity_store_clear(store);
+    return (true);
+}
+
+void                    jo_entity_store_destroy(jo_entity_store * const store)
+{
+    if (store->capacity > 0)
+        jo_free(store->x);
+    store->x = JO_NULL;
+    JO_ZERO(store->capacity);
+    JO_ZERO(store->count);
+    JO_ZERO(store->free_count);
+}
+
+void                    jo_entity_store_clear(jo_entity_store * const store)
+{
+    int                 i;
+
+    for (JO_ZERO(i); i < JO_DIV_BY_32(store->capacity + 31); ++i)
+        JO_ZERO(store->alive[i]);
+    /* Lowest indexes are spawned first */
+    for (JO_ZERO(i); i < store->capacity; ++i)
+        store->free_slots[i] = store->capacity - 1 - i;
+    store->free_count = store->capacity;
+    JO_ZERO(store->count);
+}
+
+void                    jo_entity_store_move(jo_entity_store * const store)
+{
+    register int        *x = store->x;
+    register int        *y = store->y;
+    register int        *vx = store->vx;
+    register int        *vy = store->vy;
+    register unsigned int bits;
+    register int        index;
+    int                 end;
+    int                 word;
+
+    for (JO_ZERO(word); word < JO_DIV_BY_32(store->capacity + 31); ++word)
+    {
+        bits = store->alive[word];
+        index = JO_MULT_BY_32(word);
+        if (bits == 0xFFFFFFFF)
+        {
+            /* Full word: no test at all */
+            for (end = index + 32; index < end; ++index)
+            {
+                x[index] += vx[index];
+                y[index] += vy[index];
+            }
+            continue;
+        }
+        for (; bits; bits >>= 1, ++index)
+            if (bits & 1)
+            {
+                x[index] += vx[index];
+                y[index] += vy[index];
+            }
+    }
+}
+
+int                     jo_entity_store_kill_outside(jo_entity_store * const store, const int left, const int top, const int right, const int bottom)
+{
+    register unsigned int bits;
+    register int        index;
+    int                 word;
+    int                 killed;
+    const int           fixed_left = JO_MULT_BY_65536(left);
+    const int           fixed_top = JO_MULT_BY_65536(top);
+    const int           fixed_right = JO_MULT_BY_65536(right);
+    const int           fixed_bottom = JO_MULT_BY_65536(bottom);
+
+    JO_ZERO(killed);
+    for (JO_ZERO(word); word < JO_DIV_BY_32(store->capacity + 31); ++word)
+        for (bits = store->alive[word], index = JO_MULT_BY_32(word); bits; bits >>= 1, ++index)
+            if ((bits & 1) && (store->x[index] < fixed_left || store->x[index] > fixed_right ||
+                               store->y[index] < fixed_top || store->y[index] > fixed_bottom))
+            {
+                jo_entity_kill(store, index);
+                ++killed;
+            }
+    return (killed);
+}
+
+int                     jo_entity_store_move_and_kill_outside(jo_entity_store * const store, const int left, const int top, const int right, const int bottom)
+{
+    register int        *x = store->x;
+    register int        *y = store->y;
+    register int        *vx = store->vx;
+    register int        *vy = store->vy;
+    register unsigned int bits;
+    register unsigned int bit;
+    register unsigned int dead;
+    register int        index;
+    register int        px;
+    register int        py;
+    int                 word;
+    int                 killed;
+    const int           fixed_left = JO_MULT_BY_65536(left);
+    const int           fixed_top = JO_MULT_BY_65536(top);
+    /* Outside when (unsigned)(position - left) > width: one test per axis */
+    const unsigned int  fixed_width = (unsigned int)(JO_MULT_BY_65536(right) - fixed_left);
+    const unsigned int  fixed_height = (unsigned int)(JO_MULT_BY_65536(bottom) - fixed_top);
+
+    JO_ZERO(killed);
+    for (JO_ZERO(word); word < JO_DIV_BY_32(store->capacity + 31); ++word)
+    {
+        bits = store->alive[word];
+        index = JO_MULT_BY_32(word);
+        JO_ZERO(dead);
+        if (bits == 0xFFFFFFFF)
+        {
+            /* Full word: no alive test */
+            for (bit = 1; bit; bit <<= 1, ++index)
+            {
+                x[index] = px = x[index] + vx[index];
+                y[index] = py = y[index] + vy[index];
+                if ((unsigned int)(px - fixed_left) > fixed_width || (unsigned int)(py - fixed_top) > fixed_height)
+                    dead |= bit;
+            }
+        }
+        else
+        {
+            for (bit = 1; bits; bits >>= 1, bit <<= 1, ++index)
+                if (bits & 1)
+                {
+                    x[index] = px = x[index] + vx[index];
+                    y[index] = py = y[index] + vy[index];
+                    if ((unsigned int)(px - fixed_left) > fixed_width || (unsigned int)(py - fixed_top) > fixed_height)
+                        dead |= bit;
+                }
+        }
+        if (dead == 0)
+            continue;
+        /* Killed entities leave the bitmask once per word, free slots are pushed in the jo_entity_kill() order */
+        store->alive[word] &= ~dead;
+        for (index = JO_MULT_BY_32(word); dead; dead >>= 1, ++index)
+            if (dead & 1)
+            {
+                store->free_slots[store->free_count++] = index;
+                ++killed;
+            }
+    }
+    store->count -= killed;
+    return (killed);
+}
+
+int                     jo_entity_store_kill_inside(jo_entity_store * const store, const int left, const int top, const int right, const int bottom)
+{
+    register unsigned int bits;
+    register int        index;
+    int                 word;
+    int                 killed;
+    const int           fixed_left = JO_MULT_BY_65536(left);
+    const int           fixed_top = JO_MULT_BY_65536(top);
+    const int           fixed_right = JO_MULT_BY_65536(right);
+    const int           fixed_bottom = JO_MULT_BY_65536(bottom);
+
+    JO_ZERO(killed);
+    if (store->count <= 0)
+        return (0);
+    for (JO_ZERO(word); word < JO_DIV_BY_32(store->capacity + 31); ++word)
+        for (bits = store->alive[word], index = JO_MULT_BY_32(word); bits; bits >>= 1, ++index)
+            if ((bits & 1) && store->x[index] >= fixed_left && store->x[index] < fixed_right &&
+                store->y[index] >= fixed_top && store->y[index] < fixed_bottom)
+            {
+                jo_entity_kill(store, index);
+                ++killed;
+            }
+    return (killed);
+}
+
+/*
+** END OF FILE
+*/
@@ -175,7 +175,7 @@ bool                    jo_fs_read_file_async(const char *const filename, jo_fs_
         }
         GFS_GetFileSize(__jo_fs_background_jobs[i].gfs, &sctsize, &nsct, &lastsize);
         __jo_fs_background_jobs[i].file_length = (sctsize * (nsct - 1) + lastsize);
-        if ((__jo_fs_background_jobs[i].contents = jo_malloc(sctsize * nsct + 1)) == JO_NULL)
+        if ((__jo_fs_background_jobs[i].contents = jo_malloc_with_placement(sctsize * nsct + 1, JO_FAST_ALLOCATION, JO_ZONE_PREFER_BULK)) == JO_NULL)
         {
 #ifdef JO_DEBUG
             jo_core_error("%s: Out of memory", filename);
@@ -261,7 +261,7 @@ char*					jo_fs_read_file(const char *const filename, int *len)
     fsize = jo_fs_get_file_size(fid);
     if (fsize < 0)
         return (JO_NULL);
-    if ((stream = (char *)jo_malloc_with_behaviour((fsize + 1) * sizeof(*stream), JO_MALLOC_TRY_REUSE_BLOCK)) == JO_NULL)
+    if ((stream = (char *)jo_malloc_with_placement((fsize + 1) * sizeof(*stream), JO_MALLOC_TRY_REUSE_BLOCK, JO_ZONE_PREFER_BULK)) == JO_NULL)
     {
 #ifdef JO_DEBUG
         jo_core_error("%s: Out of memory", filename);
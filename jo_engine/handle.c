@@ -0,0 +1,231 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** INCLUDES
+*/
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/handle.h"
+
+/*
+** The relocatable heap is a contiguous area where blocks are always allocated at the top.
+** jo_handle_free() only marks the block, then the compactor slides live blocks down
+** (a few KB per frame) and updates the handle table:
+**
+**   begin            dest             scan                    top           end
+**     | packed blocks  | already moved  | blocks not processed  | free space  |
+**
+** __jo_handle_hole_bytes counts every byte that compaction will give back, including
+** the dest..scan gap that is only released (top = dest) when the pass ends.
+*/
+
+typedef struct
+{
+    jo_handle       handle;/* JO_INVALID_HANDLE if the block is free */
+    unsigned short  reserved;
+    unsigned int    size;
+}                   jo_handle_block;
+
+void                **__jo_handle_table = JO_NULL;
+unsigned int        __jo_handle_hole_bytes = 0;
+
+static unsigned char    *__jo_handle_heap_begin = JO_NULL;
+static unsigned char    *__jo_handle_heap_top;
+static unsigned char    *__jo_handle_heap_end;
+static unsigned char    *__jo_handle_heap_scan = JO_NULL;
+static unsigned char    *__jo_handle_heap_dest;
+static jo_handle        *__jo_handle_free_slots;
+static unsigned int     __jo_handle_free_slot_count;
+
+bool                    jo_handle_heap_init(const unsigned int size_in_bytes, const unsigned int max_handles)
+{
+    register unsigned int   i;
+
+#ifdef JO_DEBUG
+    if (__jo_handle_heap_begin != JO_NULL)
+    {
+        jo_core_error("Relocatable heap already initialized");
+        return (false);
+    }
+    if (max_handles == 0 || max_handles > 0xFFFF)
+    {
+        jo_core_error("Invalid max_handles (%d)", max_handles);
+        return (false);
+    }
+#endif
+    /* Slot 0 is JO_INVALID_HANDLE */
+    if ((__jo_handle_table = (void **)jo_malloc_with_behaviour((max_handles + 1) * sizeof(*__jo_handle_table), JO_MALLOC_TRY_REUSE_BLOCK)) == JO_NULL)
+        goto handle_heap_out_of_memory;
+    if ((__jo_handle_free_slots = (jo_handle *)jo_malloc_with_behaviour(max_handles * sizeof(*__jo_handle_free_slots), JO_MALLOC_TRY_REUSE_BLOCK)) == JO_NULL)
+    {
+        jo_free(__jo_handle_table);
+        goto handle_heap_out_of_memory;
+    }
+    if ((__jo_handle_heap_begin = (unsigned char *)jo_malloc_with_behaviour(size_in_bytes, JO_MALLOC_TRY_REUSE_BLOCK)) == JO_NULL)
+    {
+        jo_free(__jo_handle_free_slots);
+        jo_free(__jo_handle_table);
+        goto handle_heap_out_of_memory;
+    }
+    __jo_handle_heap_top = __jo_handle_heap_begin;
+    __jo_handle_heap_end = __jo_handle_heap_begin + (size_in_bytes & ~3);
+    __jo_handle_heap_scan = JO_NULL;
+    JO_ZERO(__jo_handle_hole_bytes);
+    __jo_handle_table[JO_INVALID_HANDLE] = JO_NULL;
+    for (JO_ZERO(i); i < max_handles; ++i)
+        __jo_handle_free_slots[i] = (jo_handle)(max_handles - i);
+    __jo_handle_free_slot_count = max_handles;
+    return (true);
+handle_heap_out_of_memory:
+#ifdef JO_DEBUG
+    jo_core_error("Out of memory");
+#endif
+    __jo_handle_table = JO_NULL;
+    __jo_handle_heap_begin = JO_NULL;
+    return (false);
+}
+
+jo_handle               jo_handle_alloc(unsigned int n)
+{
+    jo_handle_block     *block;
+    jo_handle           handle;
+
+#ifdef JO_DEBUG
+    if (__jo_handle_heap_begin == JO_NULL)
+    {
+        jo_core_error("Call jo_handle_heap_init() first");
+        return (JO_INVALID_HANDLE);
+    }
+#endif
+    if (__jo_handle_free_slot_count == 0)
+        return (JO_INVALID_HANDLE);
+    n = (n + sizeof(*block) + 3) & ~3;
+    if ((__jo_handle_heap_top + n) > __jo_handle_heap_end)
+    {
+        if (__jo_handle_hole_bytes == 0)
+            return (JO_INVALID_HANDLE);
+        jo_handle_compact();
+        if ((__jo_handle_heap_top + n) > __jo_handle_heap_end)
+            return (JO_INVALID_HANDLE);
+    }
+    handle = __jo_handle_free_slots[--__jo_handle_free_slot_count];
+    block = (jo_handle_block *)__jo_handle_heap_top;
+    block->handle = handle;
+    block->size = n;
+    __jo_handle_heap_top += n;
+    __jo_handle_table[handle] = block + 1;
+    return (handle);
+}
+
+void                    jo_handle_free(const jo_handle handle)
+{
+    jo_handle_block     *block;
+
+#ifdef JO_DEBUG
+    if (handle == JO_INVALID_HANDLE || __jo_handle_table[handle] == JO_NULL)
+    {
+        jo_core_error("Invalid handle (%d)", handle);
+        return;
+    }
+#endif
+    block = ((jo_handle_block *)__jo_handle_table[handle]) - 1;
+    __jo_handle_table[handle] = JO_NULL;
+    __jo_handle_free_slots[__jo_handle_free_slot_count++] = handle;
+    JO_ZERO(block->handle);
+    if (((unsigned char *)block + block->size) == __jo_handle_heap_top && (unsigned char *)block >= __jo_handle_heap_scan)
+        __jo_handle_heap_top = (unsigned char *)block;
+    else
+        __jo_handle_hole_bytes += block->size;
+}
+
+bool                    jo_handle_compact_step(unsigned int max_bytes_moved)
+{
+    jo_handle_block     *block;
+    bool                moved;
+    register int        *src;
+    register int        *dest;
+    register int        *end;
+
+    if (__jo_handle_hole_bytes == 0 && __jo_handle_heap_scan == JO_NULL)
+        return (false);
+    if (__jo_handle_heap_scan == JO_NULL)
+    {
+        __jo_handle_heap_scan = __jo_handle_heap_begin;
+        __jo_handle_heap_dest = __jo_handle_heap_begin;
+    }
+    moved = false;
+    while (__jo_handle_heap_scan < __jo_handle_heap_top)
+    {
+        block = (jo_handle_block *)__jo_handle_heap_scan;
+        __jo_handle_heap_scan += block->size;
+        if (block->handle == JO_INVALID_HANDLE)
+            continue;
+        if ((unsigned char *)block != __jo_handle_heap_dest)
+        {
+            /* A block bigger than the budget is still moved when it comes first, otherwise the pass would never end */
+            if (block->size > max_bytes_moved && moved)
+            {
+                __jo_handle_heap_scan = (unsigned char *)block;
+                return (true);
+            }
+            max_bytes_moved = block->size > max_bytes_moved ? 0 : max_bytes_moved - block->size;
+            moved = true;
+            /* Regions may overlap but dest is always below src */
+            end = (int *)__jo_handle_heap_scan;
+            for (src = (int *)block, dest = (int *)__jo_handle_heap_dest; src < end; ++src, ++dest)
+                *dest = *src;
+            block = (jo_handle_block *)__jo_handle_heap_dest;
+            __jo_handle_table[block->handle] = block + 1;
+        }
+        __jo_handle_heap_dest += block->size;
+    }
+    __jo_handle_hole_bytes -= __jo_handle_heap_top - __jo_handle_heap_dest;
+    __jo_handle_heap_top = __jo_handle_heap_dest;
+    __jo_handle_heap_scan = JO_NULL;
+    return (__jo_handle_hole_bytes != 0);
+}
+
+unsigned int            jo_handle_heap_free_bytes(void)
+{
+    if (__jo_handle_heap_begin == JO_NULL)
+        return (0);
+    return ((__jo_handle_heap_end - __jo_handle_heap_top) + __jo_handle_hole_bytes);
+}
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,345 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** INCLUDES
+*/
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/fs.h"
+#include "jo/sprites.h"
+#include "jo/collision.h"
+#include "jo/hitbox.h"
+
+/*
+** HITBOX DEFINITION
+*/
+
+static  __jo_force_inline void  __jo_hitbox_edges_from_box(const int sprite_id, const jo_aabb * const box, jo_hitbox_edges * const edges)
+{
+    edges->left = box->x - JO_DIV_BY_2(__jo_sprite_def[sprite_id].width);
+    edges->top = box->y - JO_DIV_BY_2(__jo_sprite_def[sprite_id].height);
+    edges->right = edges->left + box->width;
+    edges->bottom = edges->top + box->height;
+}
+
+static void                 __jo_hitbox_free_boxes(const int sprite_id)
+{
+    if (__jo_sprite_hitbox[sprite_id].boxes == JO_NULL)
+        return ;
+    jo_free(__jo_sprite_hitbox[sprite_id].boxes);
+    __jo_sprite_hitbox[sprite_id].boxes = JO_NULL;
+}
+
+void                        jo_hitbox_reset(const int sprite_id)
+{
+    jo_aabb                 box;
+
+    JO_ZERO(box.x);
+    JO_ZERO(box.y);
+    box.width = __jo_sprite_def[sprite_id].width;
+    box.height = __jo_sprite_def[sprite_id].height;
+    jo_hitbox_set_boxes(sprite_id, &box, 1);
+}
+
+void                        jo_hitbox_set(const int sprite_id, const int x, const int y, const int width, const int height)
+{
+    jo_aabb                 box;
+
+    box.x = x;
+    box.y = y;
+    box.width = width;
+    box.height = height;
+    jo_hitbox_set_boxes(sprite_id, &box, 1);
+}
+
+bool                        jo_hitbox_set_boxes(const int sprite_id, const jo_aabb * const boxes, const int count)
+{
+    jo_sprite_hitbox        *hitbox;
+    jo_hitbox_edges         *edges;
+    register int            i;
+
+#ifdef JO_DEBUG
+    if (boxes == JO_NULL || count <= 0)
+    {
+        jo_core_error("Invalid hitboxes");
+        return (false);
+    }
+#endif
+    hitbox = &__jo_sprite_hitbox[sprite_id];
+    if (count == 1)
+    {
+        __jo_hitbox_free_boxes(sprite_id);
+        __jo_hitbox_edges_from_box(sprite_id, boxes, &hitbox->bounds);
+        hitbox->count = 1;
+        return (true);
+    }
+    if ((edges = (jo_hitbox_edges *)jo_malloc_with_behaviour(count * sizeof(*edges), JO_MALLOC_TRY_REUSE_BLOCK)) == JO_NULL)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Out of memory");
+#endif
+        return (false);
+    }
+    __jo_hitbox_free_boxes(sprite_id);
+    for (JO_ZERO(i); i < count; ++i)
+    {
+        __jo_hitbox_edges_from_box(sprite_id, &boxes[i], &edges[i]);
+        if (i == 0)
+        {
+            hitbox->bounds = edges[0];
+            continue;
+        }
+        hitbox->bounds.left = JO_MIN(hitbox->bounds.left, edges[i].left);
+        hitbox->bounds.top = JO_MIN(hitbox->bounds.top, edges[i].top);
+        hitbox->bounds.right = JO_MAX(hitbox->bounds.right, edges[i].right);
+        hitbox->bounds.bottom = JO_MAX(hitbox->bounds.bottom, edges[i].bottom);
+    }
+    hitbox->count = count;
+    hitbox->boxes = edges;
+    return (true);
+}
+
+#ifdef JO_COMPILE_WITH_FS_SUPPORT
+
+/*
+** HITBOX FILE
+*/
+
+static bool                 __jo_hitbox_parse_int(char **stream, int *value)
+{
+    bool                    is_negative;
+
+    while (**stream && jo_tools_is_whitespace(**stream))
+        ++(*stream);
+    if (!**stream)
+        return (false);
+    is_negative = (**stream == '-');
+    if (is_negative)
+        ++(*stream);
+    if (**stream < '0' || **stream > '9')
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Invalid hitbox file: %s", *stream);
+#endif
+        return (false);
+    }
+    for (JO_ZERO(*value); **stream >= '0' && **stream <= '9'; ++(*stream))
+        *value = *value * 10 + (**stream - '0');
+    if (is_negative)
+        *value = -*value;
+    return (true);
+}
+
+bool                        jo_hitbox_load_from_file(const int first_sprite_id, const char * const sub_dir, const char * const filename)
+{
+    char                    *stream;
+    char                    *stream_begin;
+    jo_aabb                 boxes[JO_HITBOX_MAX_BOXES_PER_SPRITE];
+    int                     count;
+    int                     tile;
+    int                     current_tile;
+    int                     value[4];
+    bool                    success;
+    register int            i;
+
+    if ((stream = jo_fs_read_file_in_dir(filename, sub_dir, JO_NULL)) == JO_NULL)
+        return (false);
+    stream_begin = stream;
+    success = true;
+    JO_ZERO(count);
+    current_tile = -1;
+    while (__jo_hitbox_parse_int(&stream, &tile))
+    {
+        for (JO_ZERO(i); i < 4; ++i)
+            if (!__jo_hitbox_parse_int(&stream, &value[i]))
+                break;
+        if (i < 4)
+        {
+            success = false;
+            break;
+        }
+        if (tile != current_tile && count > 0)
+        {
+            success &= jo_hitbox_set_boxes(first_sprite_id + current_tile, boxes, count);
+            JO_ZERO(count);
+        }
+#ifdef JO_DEBUG
+        if (tile < 0 || first_sprite_id + tile > jo_get_last_sprite_id())
+        {
+            jo_core_error("Invalid tile index %d in %s", tile, filename);
+            success = false;
+            break;
+        }
+#endif
+        if (count >= JO_HITBOX_MAX_BOXES_PER_SPRITE)
+        {
+#ifdef JO_DEBUG
+            jo_core_error("Too many hitboxes for tile %d in %s", tile, filename);
+#endif
+            success = false;
+            break;
+        }
+        current_tile = tile;
+        boxes[count].x = value[0];
+        boxes[count].y = value[1];
+        boxes[count].width = value[2];
+        boxes[count].height = value[3];
+        ++count;
+    }
+    if (success && count > 0)
+        success = jo_hitbox_set_boxes(first_sprite_id + current_tile, boxes, count);
+    jo_free(stream_begin);
+    return (success);
+}
+
+#endif /* !JO_COMPILE_WITH_FS_SUPPORT */
+
+/*
+** HITBOX DETECTION
+*/
+
+bool                        __jo_hitbox_detection_boxes(const jo_sprite_hitbox * const hitbox, const int x, const int y,
+                                                        const int left, const int top, const int right, const int bottom)
+{
+    const jo_hitbox_edges   *edges;
+    register int            i;
+
+    if (hitbox->boxes == JO_NULL)
+        return (x + hitbox->bounds.left < right && left < x + hitbox->bounds.right &&
+                y + hitbox->bounds.top < bottom && top < y + hitbox->bounds.bottom);
+    for (JO_ZERO(i), edges = hitbox->boxes; i < hitbox->count; ++i, ++edges)
+        if (x + edges->left < right && left < x + edges->right &&
+            y + edges->top < bottom && top < y + edges->bottom)
+            return (true);
+    return (false);
+}
+
+/*
+** PIXEL PERFECT
+*/
+
+/* Masks cover the whole sprite, not the hitboxes */
+static  __jo_force_inline void  __jo_hitbox_get_sprite_aabb(const int sprite_id, const int x, const int y, jo_aabb * const box)
+{
+    box->x = x - JO_DIV_BY_2(__jo_sprite_def[sprite_id].width);
+    box->y = y - JO_DIV_BY_2(__jo_sprite_def[sprite_id].height);
+    box->width = __jo_sprite_def[sprite_id].width;
+    box->height = __jo_sprite_def[sprite_id].height;
+}
+
+/* 32 mask bits of a row from column (negative for a flipped sprite), MSB first, bits outside the row are 0 */
+static  __jo_force_inline unsigned int  __jo_hitbox_mask_row_bits(const unsigned int * const row, const int words_per_row, const int column)
+{
+    register int                        word;
+    register int                        shift;
+    register unsigned int               bits;
+
+    if (column < 0)
+        return (row[0] >> -column);
+    word = JO_DIV_BY_32(column);
+    shift = column & 31;
+    bits = row[word] << shift;
+    if (shift && word + 1 < words_per_row)
+        bits |= row[word + 1] >> (32 - shift);
+    return (bits);
+}
+
+static  __jo_force_inline unsigned int  __jo_hitbox_reverse_bits(register unsigned int bits)
+{
+    bits = ((bits >> 1) & 0x55555555) | ((bits & 0x55555555) << 1);
+    bits = ((bits >> 2) & 0x33333333) | ((bits & 0x33333333) << 2);
+    bits = ((bits >> 4) & 0x0F0F0F0F) | ((bits & 0x0F0F0F0F) << 4);
+    bits = ((bits >> 8) & 0x00FF00FF) | ((bits & 0x00FF00FF) << 8);
+    return ((bits >> 16) | (bits << 16));
+}
+
+/* 32 mask bits from (x, y) in screen coordinates, MSB first, bits past the end of the row are 0.
+** A horizontally flipped sprite reads the mirrored columns (box->width - 1 - column) backward.
+*/
+static  __jo_force_inline unsigned int  __jo_hitbox_mask_bits(const int sprite_id, const jo_aabb * const box, const bool horizontal_flip, const int x, const int y)
+{
+    const unsigned int                  *row;
+    register int                        words_per_row;
+
+    /* A sprite without mask is fully opaque */
+    if (__jo_sprite_mask[sprite_id] == JO_NULL)
+        return (0xFFFFFFFF);
+    words_per_row = JO_DIV_BY_32(box->width + 31);
+    row = __jo_sprite_mask[sprite_id] + (y - box->y) * words_per_row;
+    if (!horizontal_flip)
+        return (__jo_hitbox_mask_row_bits(row, words_per_row, x - box->x));
+    return (__jo_hitbox_reverse_bits(__jo_hitbox_mask_row_bits(row, words_per_row, box->width - 32 - (x - box->x))));
+}
+
+bool                        jo_hitbox_pixel_overlap(const int sprite_id1, const int x1, const int y1, const bool horizontal_flip1,
+                                                    const int sprite_id2, const int x2, const int y2, const bool horizontal_flip2)
+{
+    jo_aabb                 box1;
+    jo_aabb                 box2;
+    int                     left;
+    int                     right;
+    int                     top;
+    int                     bottom;
+    register int            x;
+    register int            y;
+    register unsigned int   bits;
+
+    __jo_hitbox_get_sprite_aabb(sprite_id1, x1, y1, &box1);
+    __jo_hitbox_get_sprite_aabb(sprite_id2, x2, y2, &box2);
+    if (!jo_aabb_intersect(&box1, &box2))
+        return (false);
+    if (__jo_sprite_mask[sprite_id1] == JO_NULL && __jo_sprite_mask[sprite_id2] == JO_NULL)
+        return (true);
+    left = JO_MAX(box1.x, box2.x);
+    right = JO_MIN(box1.x + box1.width, box2.x + box2.width);
+    top = JO_MAX(box1.y, box2.y);
+    bottom = JO_MIN(box1.y + box1.height, box2.y + box2.height);
+    for (y = top; y < bottom; ++y)
+        for (x = left; x < right; x += 32)
+        {
+            bits = __jo_hitbox_mask_bits(sprite_id1, &box1, horizontal_flip1, x, y) & __jo_hitbox_mask_bits(sprite_id2, &box2, horizontal_flip2, x, y);
+            if (right - x < 32)
+                bits &= ~(0xFFFFFFFF >> (right - x));
+            if (bits)
+                return (true);
+        }
+    return (false);
+}
+
+/*
+** END OF FILE
+*/
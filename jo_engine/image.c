@@ -55,8 +55,8 @@ unsigned short      *__jo_bin_load(jo_img *img, const char * const sub_dir, cons
     stream = (unsigned short *)jo_fs_read_file_in_dir(filename, sub_dir, JO_NULL);
     if (stream == JO_NULL)
         return (JO_NULL);
-    img->width = jo_swap_endian_ushort(*stream);
-    img->height = jo_swap_endian_ushort(*(stream + 1));
+    img->width = jo_little_endian_to_ushort(*stream);
+    img->height = jo_little_endian_to_ushort(*(stream + 1));
     if (img->data == JO_NULL)
         img->data = stream;
     if (img->data == JO_NULL)
@@ -90,10 +90,10 @@ bool                    jo_bin_loader_from_stream(jo_img *img, char *stream, con
     register int        i;
     register int        size;
 
-    img->width = jo_swap_endian_ushort(*stream);
-    img->height = jo_swap_endian_ushort(*(stream + 1));
+    img->width = jo_little_endian_to_ushort(*stream);
+    img->height = jo_little_endian_to_ushort(*(stream + 1));
     if (img->data == JO_NULL)
-        img->data = (unsigned short *)jo_malloc(img->height * img->width * sizeof(*img->data));
+        img->data = (unsigned short *)jo_malloc_with_placement(img->height * img->width * sizeof(*img->data), JO_FAST_ALLOCATION, JO_ZONE_PREFER_BULK);
     if (img->data == JO_NULL)
     {
 #ifdef JO_DEBUG
@@ -105,7 +105,7 @@ bool                    jo_bin_loader_from_stream(jo_img *img, char *stream, con
     size = img->width * img->height;
     for (JO_ZERO(i); i < size; ++i)
     {
-        img->data[i] = jo_swap_endian_ushort(*(stream + i));
+        img->data[i] = jo_little_endian_to_ushort(*(stream + i));
         if (transparent_color != JO_COLOR_Transparent && img->data[i] == transparent_color)
             img->data[i] = JO_COLOR_Transparent;
     }
@@ -129,7 +129,7 @@ bool                    jo_bin_loader(jo_img *img, const char * const sub_dir, c
     size = img->width * img->height;
     for (JO_ZERO(i); i < size; ++i)
     {
-        img->data[i] = jo_swap_endian_ushort(*(stream + i));
+        img->data[i] = jo_little_endian_to_ushort(*(stream + i));
         if (transparent_color != JO_COLOR_Transparent && img->data[i] == transparent_color)
             img->data[i] = JO_COLOR_Transparent;
     }
@@ -197,7 +197,7 @@ int		                    jo_sprite_add_bin_tileset(const char * const sub_dir, c
 #endif
         tile_image.width = tileset[i].width;
         tile_image.height = tileset[i].height;
-        tile_image.data = (unsigned short *)jo_malloc_with_behaviour(tile_image.height * tile_image.width * sizeof(*tile_image.data), JO_MALLOC_TRY_REUSE_BLOCK);
+        tile_image.data = (unsigned short *)jo_malloc_with_placement(tile_image.height * tile_image.width * sizeof(*tile_image.data), JO_MALLOC_TRY_REUSE_BLOCK, JO_ZONE_PREFER_BULK);
         if (tile_image.data == JO_NULL)
         {
 #ifdef JO_DEBUG
@@ -211,7 +211,7 @@ int		                    jo_sprite_add_bin_tileset(const char * const sub_dir, c
             for (JO_ZERO(x); x < tile_image.width; ++x)
             {
                 idx = x + y * tile_image.width;
-                tile_image.data[idx] = jo_swap_endian_ushort(stream[(x + tileset[i].x) + (y + tileset[i].y) * full_image.width]);
+                tile_image.data[idx] = jo_little_endian_to_ushort(stream[(x + tileset[i].x) + (y + tileset[i].y) * full_image.width]);
                 if (transparent_color != JO_COLOR_Transparent && tile_image.data[idx] == transparent_color)
                     tile_image.data[idx] = JO_COLOR_Transparent;
             }
@@ -97,6 +97,20 @@ void                jo_input_update(void)
 
 #endif
 
+void                jo_input_clear_events(void)
+{
+#if JO_COMPILE_USING_SGL
+    /* Bits of pushed keys are 0 */
+    Smpc_Peripheral[0].push = 0xFFFF;
+    Smpc_Peripheral[1].push = 0xFFFF;
+#else
+    JO_ZERO(jo_inputs[0].on_keydown);
+    JO_ZERO(jo_inputs[0].on_keyup);
+    JO_ZERO(jo_inputs[1].on_keydown);
+    JO_ZERO(jo_inputs[1].on_keyup);
+#endif
+}
+
 jo_gamepad_type                 jo_get_input_type(const int port)
 {
 #if JO_COMPILE_USING_SGL
@@ -0,0 +1,157 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/** @file arena.h
+ *  @author Johannes Fetz
+ *
+ *  @brief Jo Engine Linear (bump) allocator and per-frame scratch memory
+ *  @bug No known bugs.
+ */
+
+#ifndef __JO_ARENA_H__
+# define __JO_ARENA_H__
+
+/** @brief Frame arena size in bytes (can be overridden with -DJO_FRAME_ARENA_SIZE=...) */
+#ifndef JO_FRAME_ARENA_SIZE
+# define JO_FRAME_ARENA_SIZE                (16384)
+#endif
+
+/** @brief Linear allocator: allocation moves a pointer forward, everything is released at once by jo_arena_reset() */
+typedef struct
+{
+    unsigned char   *begin;
+    unsigned char   *current;
+    unsigned char   *end;
+}                   jo_arena;
+
+/** @brief Init an arena and reserve its storage
+ *  @param arena Arena pointer
+ *  @param size_in_bytes Arena capacity
+ *  @return true if the storage has been allocated otherwise false
+ */
+bool                                jo_arena_init(jo_arena * const arena, const unsigned int size_in_bytes);
+
+/** @brief Free arena storage
+ *  @param arena Arena pointer
+ */
+void                                jo_arena_destroy(jo_arena * const arena);
+
+/** @brief Allocate memory from the arena
+ *  @param arena Arena pointer
+ *  @param n Size in bytes
+ *  @return a pointer (4 bytes aligned) to the allocated memory or NULL if the arena is full
+ *  @warning Memory can't be freed individually
+ */
+static  __jo_force_inline void      *jo_arena_alloc(jo_arena * const arena, unsigned int n)
+{
+    unsigned char   *ptr;
+
+    n = (n + 3) & ~3;
+    ptr = arena->current;
+    if ((ptr + n) > arena->end)
+        return JO_NULL;
+    arena->current += n;
+    return ptr;
+}
+
+/** @brief Release everything allocated in the arena
+ *  @param arena Arena pointer
+ */
+static  __jo_force_inline void      jo_arena_reset(jo_arena * const arena)
+{
+    arena->current = arena->begin;
+}
+
+/** @brief Check if the pointer has been allocated from the arena
+ *  @param arena Arena pointer
+ *  @param ptr Pointer
+ *  @return true if ptr belongs to the arena storage
+ */
+static  __jo_force_inline bool      jo_arena_contains(const jo_arena * const arena, const void * const ptr)
+{
+    return ((unsigned char *)ptr >= arena->begin && (unsigned char *)ptr < arena->end);
+}
+
+/** @brief Get arena usage in bytes
+ *  @param arena Arena pointer
+ *  @return Used bytes
+ */
+static  __jo_force_inline unsigned int  jo_arena_usage(const jo_arena * const arena)
+{
+    return (arena->current - arena->begin);
+}
+
+/*
+** FRAME ARENA
+*/
+
+/** @brief Frame arena (internal engine usage) use jo_frame_arena_alloc() instead
+ *  @warning MC Hammer: don't touch this
+ */
+extern jo_arena                     __jo_frame_arena;
+
+/** @brief Reserve the frame arena storage then allocate from it (internal engine usage)
+ *  @warning MC Hammer: don't touch this
+ */
+void                                *__jo_frame_arena_first_alloc(const unsigned int n);
+
+/** @brief Allocate scratch memory that lives until the end of the current frame
+ *  @param n Size in bytes
+ *  @return a pointer to the allocated memory or NULL if JO_FRAME_ARENA_SIZE is reached
+ *  @remarks jo_core_run() releases the whole frame arena at the beginning of each frame (never call jo_free() on it)
+ *  @remarks The JO_FRAME_ARENA_SIZE bytes are taken from the heap by the first call, games that never use the frame arena don't pay for it
+ *  @warning Main CPU only
+ */
+static  __jo_force_inline void      *jo_frame_arena_alloc(unsigned int n)
+{
+    if (__jo_frame_arena.begin == JO_NULL)
+        return __jo_frame_arena_first_alloc(n);
+    return jo_arena_alloc(&__jo_frame_arena, n);
+}
+
+/** @brief Check if the pointer has been allocated from the frame arena
+ *  @param ptr Pointer
+ *  @return true if ptr belongs to the frame arena
+ */
+static  __jo_force_inline bool      jo_frame_arena_contains(const void * const ptr)
+{
+    return jo_arena_contains(&__jo_frame_arena, ptr);
+}
+
+/** @brief Get frame arena usage for the current frame
+ *  @return Used bytes
+ */
+static  __jo_force_inline unsigned int  jo_frame_arena_usage(void)
+{
+    return jo_arena_usage(&__jo_frame_arena);
+}
+
+#endif /* !__JO_ARENA_H__ */
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,164 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/** @file array.h
+ *  @author Johannes Fetz
+ *
+ *  @brief Jo Engine Growable contiguous array
+ *  @bug No known bugs.
+ */
+
+#ifndef __JO_ARRAY_H__
+# define __JO_ARRAY_H__
+
+/** @brief Callback for jo_array_foreach() */
+typedef void (*jo_array_callback)(void *item);
+
+/** @brief Callback for jo_array_any() */
+typedef bool (*jo_array_any_callback)(void *item, void *extra);
+
+/** @brief Growable contiguous array
+ *  @remarks Items are stored next to each other so iteration is sequential in memory
+ */
+typedef struct
+{
+    int                     count;
+    int                     capacity;
+    unsigned int            item_size;
+    unsigned char           *items;
+    jo_malloc_behaviour     allocation_behaviour;
+}                           jo_array;
+
+/** @brief Init an array and reserve its storage
+ *  @param array Array pointer
+ *  @param item_size Size of one item in bytes
+ *  @param capacity Initial capacity (the array grows if needed)
+ *  @return true if the storage has been allocated otherwise false
+ */
+bool                                jo_array_init(jo_array * const array, unsigned int item_size, const int capacity);
+
+/** @brief Init an array for a specific type
+ *  @param array Array pointer
+ *  @param type Item type
+ *  @param capacity Initial capacity
+ */
+# define jo_array_init_for_type(array, type, capacity)     jo_array_init((array), sizeof(type), (capacity))
+
+/** @brief Free array storage
+ *  @param array Array pointer
+ */
+void                                jo_array_destroy(jo_array * const array);
+
+/** @brief Double the array capacity
+ *  @param array Array pointer
+ *  @return true on success otherwise false
+ *  @warning MC Hammer: don't touch this
+ */
+bool                                __jo_array_grow(jo_array * const array);
+
+/** @brief Get an item
+ *  @param array Array pointer
+ *  @param index Item index
+ *  @return Item pointer (valid until the next jo_array_push())
+ */
+static  __jo_force_inline void      *jo_array_at(const jo_array * const array, const int index)
+{
+    return (array->items + index * array->item_size);
+}
+
+/** @brief Add an item at the end of the array
+ *  @param array Array pointer
+ *  @return Pointer to the new (uninitialized) item or NULL if out of memory
+ */
+static  __jo_force_inline void      *jo_array_push(jo_array * const array)
+{
+    if (array->count >= array->capacity && !__jo_array_grow(array))
+        return (JO_NULL);
+    return (jo_array_at(array, array->count++));
+}
+
+/** @brief Remove an item by moving the last item in its place
+ *  @param array Array pointer
+ *  @param index Item index
+ *  @remarks O(1) but the order of items is not preserved
+ */
+void                                jo_array_swap_remove(jo_array * const array, const int index);
+
+/** @brief Remove an item and preserve the order of the following items
+ *  @param array Array pointer
+ *  @param index Item index
+ */
+void                                jo_array_remove(jo_array * const array, const int index);
+
+/** @brief Remove all items (storage is kept)
+ *  @param array Array pointer
+ */
+static  __jo_force_inline void      jo_array_clear(jo_array * const array)
+{
+    JO_ZERO(array->count);
+}
+
+/** @brief Set array memory allocation behaviour
+ *  @param array Array pointer
+ *  @param behaviour Allocation behaviour (used when the array grows)
+ */
+static  __jo_force_inline void      jo_array_set_allocation_behaviour(jo_array * const array, jo_malloc_behaviour behaviour)
+{
+    array->allocation_behaviour = behaviour;
+}
+
+/** @brief Iterate on the array
+ *  @param array Array pointer
+ *  @param callback callback for each item
+ *  @warning The callback must not add or remove items
+ */
+static  __jo_force_inline void	    jo_array_foreach(jo_array * const array, jo_array_callback callback)
+{
+    unsigned char *tmp;
+    unsigned char *end = array->items + array->count * array->item_size;
+    for (tmp = array->items; tmp < end; tmp += array->item_size) callback(tmp);
+}
+
+/** @brief Find if any item of the array satisfy the condition (callback)
+ *  @param array Array pointer
+ *  @param extra Extra data passed to the callback
+ *  @param callback callback for each item
+ *  @return true if any item satisfy the condition otherwise false
+ */
+static  __jo_force_inline bool	    jo_array_any(jo_array * const array, jo_array_any_callback callback, void *extra)
+{
+    unsigned char *tmp;
+    unsigned char *end = array->items + array->count * array->item_size;
+    for (tmp = array->items; tmp < end; tmp += array->item_size) if (callback(tmp, extra)) return true;
+    return false;
+}
+
+#endif /* !__JO_ARRAY_H__ */
+
+/*
+** END OF FILE
+*/
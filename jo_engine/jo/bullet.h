@@ -0,0 +1,172 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/** @file bullet.h
+ *  @author Johannes Fetz
+ *
+ *  @brief Jo Engine Bullet patterns (radial, aimed, spiral and wave emitters driven by binary scripts)
+ *  @bug No known bugs.
+ */
+
+#ifndef __JO_BULLET_H__
+# define __JO_BULLET_H__
+
+/** @brief Max script instructions executed by jo_bullet_emitter_update() in a single frame (can be overridden with -DJO_BULLET_SCRIPT_MAX_STEPS=...) */
+#ifndef JO_BULLET_SCRIPT_MAX_STEPS
+# define JO_BULLET_SCRIPT_MAX_STEPS         (32)
+#endif
+
+/** @brief Size of a script instruction in bytes */
+# define JO_BULLET_INSTRUCTION_SIZE         (8)
+
+/** @brief Script operation codes
+ *  @remarks Instruction layout (8 bytes, big endian): op, count, param, amplitude, speed (16 bits), angle (16 bits)
+ */
+typedef enum
+{
+    /** @brief Stop the script */
+    JO_BULLET_OP_END = 0,
+    /** @brief Wait "speed" frames */
+    JO_BULLET_OP_WAIT = 1,
+    /** @brief Jump to instruction "speed", "count" times (0 = forever), loops can't be nested */
+    JO_BULLET_OP_LOOP = 2,
+    /** @brief "count" bullets evenly spread on 360 degrees starting at "angle" */
+    JO_BULLET_OP_RADIAL = 3,
+    /** @brief "count" bullets aimed at the target, "param" degrees between each bullet, "angle" added to the aim */
+    JO_BULLET_OP_AIMED = 4,
+    /** @brief Same as radial but the pattern rotates of "param" degrees after each shot */
+    JO_BULLET_OP_SPIRAL = 5,
+    /** @brief Same as radial but the pattern swings of "amplitude" degrees around "angle", the phase moves of "param" degrees after each shot */
+    JO_BULLET_OP_WAVE = 6
+}                       jo_bullet_op;
+
+/** @brief Convert a speed in pixel per frame to the script format (8.8 fixed)
+ *  @param PIXELS Speed in pixel per frame (float allowed)
+ */
+# define JO_BULLET_SPEED(PIXELS)                    ((int)((PIXELS) * 256))
+
+/** @brief Script instruction (internal engine usage) use JO_BULLET_END, JO_BULLET_WAIT, etc */
+# define JO_BULLET_INSTRUCTION(OP, COUNT, PARAM, AMPLITUDE, SPEED, ANGLE) \
+    (unsigned char)(OP), (unsigned char)(COUNT), (unsigned char)(PARAM), (unsigned char)(AMPLITUDE), \
+    (unsigned char)(((SPEED) >> 8) & 0xFF), (unsigned char)((SPEED) & 0xFF), \
+    (unsigned char)(((ANGLE) >> 8) & 0xFF), (unsigned char)((ANGLE) & 0xFF)
+
+/** @brief Script instruction: stop the script */
+# define JO_BULLET_END()                                        JO_BULLET_INSTRUCTION(JO_BULLET_OP_END, 0, 0, 0, 0, 0)
+/** @brief Script instruction: wait FRAMES frames */
+# define JO_BULLET_WAIT(FRAMES)                                 JO_BULLET_INSTRUCTION(JO_BULLET_OP_WAIT, 0, 0, 0, FRAMES, 0)
+/** @brief Script instruction: jump to the instruction INDEX, TIMES times (0 = forever) */
+# define JO_BULLET_LOOP(INDEX, TIMES)                           JO_BULLET_INSTRUCTION(JO_BULLET_OP_LOOP, TIMES, 0, 0, INDEX, 0)
+/** @brief Script instruction: radial shot (see JO_BULLET_OP_RADIAL) */
+# define JO_BULLET_RADIAL(COUNT, SPEED, ANGLE)                  JO_BULLET_INSTRUCTION(JO_BULLET_OP_RADIAL, COUNT, 0, 0, SPEED, ANGLE)
+/** @brief Script instruction: aimed shot (see JO_BULLET_OP_AIMED) */
+# define JO_BULLET_AIMED(COUNT, SPEED, SPREAD, ANGLE)           JO_BULLET_INSTRUCTION(JO_BULLET_OP_AIMED, COUNT, SPREAD, 0, SPEED, ANGLE)
+/** @brief Script instruction: spiral shot (see JO_BULLET_OP_SPIRAL), STEP can be negative */
+# define JO_BULLET_SPIRAL(COUNT, SPEED, STEP, ANGLE)            JO_BULLET_INSTRUCTION(JO_BULLET_OP_SPIRAL, COUNT, STEP, 0, SPEED, ANGLE)
+/** @brief Script instruction: wave shot (see JO_BULLET_OP_WAVE) */
+# define JO_BULLET_WAVE(COUNT, SPEED, PHASE_STEP, AMPLITUDE, ANGLE)   JO_BULLET_INSTRUCTION(JO_BULLET_OP_WAVE, COUNT, PHASE_STEP, AMPLITUDE, SPEED, ANGLE)
+
+/** @brief Bullet emitter
+ *  @remarks Bullets are entities of a jo_entity_store, so moving, culling and collisions are done in batch with jo_entity_store_move(),
+ *  jo_entity_store_kill_outside() and jo_entity_store_kill_inside()
+ */
+typedef struct
+{
+    /** @brief Horizontal position in pixel */
+    int                     x;
+    /** @brief Vertical position in pixel */
+    int                     y;
+    /** @brief Sprite Id of the bullets */
+    int                     sprite_id;
+    const unsigned char     *script;
+    unsigned short          pc;
+    unsigned short          wait;
+    unsigned short          loop_count;
+    short                   phase;
+}                           jo_bullet_emitter;
+
+/** @brief Fire bullets evenly spread on 360 degrees
+ *  @param bullets Bullet store
+ *  @param x Horizontal position in pixel
+ *  @param y Vertical position in pixel
+ *  @param count Bullet count
+ *  @param speed Speed (see JO_BULLET_SPEED())
+ *  @param angle Angle of the first bullet in degree (0 = right, 90 = down)
+ *  @param sprite_id Sprite Id
+ *  @return Fired bullet count (lower than count if the store is full)
+ */
+int                         jo_bullet_fire_radial(jo_entity_store * const bullets, const int x, const int y, const int count, const int speed, const int angle, const int sprite_id);
+
+/** @brief Fire bullets toward a target
+ *  @param bullets Bullet store
+ *  @param x Horizontal position in pixel
+ *  @param y Vertical position in pixel
+ *  @param target_x Horizontal position of the target in pixel
+ *  @param target_y Vertical position of the target in pixel
+ *  @param count Bullet count
+ *  @param speed Speed (see JO_BULLET_SPEED())
+ *  @param spread Angle in degree between each bullet
+ *  @param angle Angle in degree added to the aim
+ *  @param sprite_id Sprite Id
+ *  @return Fired bullet count (lower than count if the store is full)
+ */
+int                         jo_bullet_fire_aimed(jo_entity_store * const bullets, const int x, const int y, const int target_x, const int target_y,
+                                                 const int count, const int speed, const int spread, const int angle, const int sprite_id);
+
+/** @brief Init an emitter
+ *  @param emitter Emitter
+ *  @param script Script (built with JO_BULLET_RADIAL(), JO_BULLET_WAIT(), etc. or loaded with jo_fs_read_file())
+ *  @param sprite_id Sprite Id of the bullets
+ *  @remarks The script is not copied
+ */
+void                        jo_bullet_emitter_init(jo_bullet_emitter * const emitter, const unsigned char * const script, const int sprite_id);
+
+/** @brief Run the script of the emitter for one frame
+ *  @param emitter Emitter
+ *  @param bullets Bullet store
+ *  @param target_x Horizontal position of the target in pixel (for aimed shots)
+ *  @param target_y Vertical position of the target in pixel (for aimed shots)
+ *  @return false when the script is over
+ */
+bool                        jo_bullet_emitter_update(jo_bullet_emitter * const emitter, jo_entity_store * const bullets, const int target_x, const int target_y);
+
+/** @brief Restart the script of the emitter
+ *  @param emitter Emitter
+ */
+static  __jo_force_inline void  jo_bullet_emitter_restart(jo_bullet_emitter * const emitter)
+{
+    JO_ZERO(emitter->pc);
+    JO_ZERO(emitter->wait);
+    JO_ZERO(emitter->loop_count);
+    JO_ZERO(emitter->phase);
+}
+
+#endif /* !__JO_BULLET_H__ */
+
+/*
+** END OF FILE
+*/
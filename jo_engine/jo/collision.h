@@ -0,0 +1,182 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/** @file collision.h
+ *  @author Johannes Fetz
+ *
+ *  @brief Jo Engine Collision broadphase (uniform grid and sweep and prune)
+ *  @bug No known bugs.
+ */
+
+#ifndef __JO_COLLISION_H__
+# define __JO_COLLISION_H__
+
+/** @brief Grid cell size in pixel = 1 << JO_COLLISION_GRID_CELL_SHIFT (can be overridden with -DJO_COLLISION_GRID_CELL_SHIFT=...) */
+#ifndef JO_COLLISION_GRID_CELL_SHIFT
+# define JO_COLLISION_GRID_CELL_SHIFT   (5)
+#endif
+
+/** @brief Axis-aligned bounding box (top-left corner and size) */
+typedef struct
+{
+    short               x;
+    short               y;
+    short               width;
+    short               height;
+}                       jo_aabb;
+
+/** @brief Callback for each object found by jo_collision_grid_query()
+ *  @return true to stop the query
+ */
+typedef bool (*jo_collision_callback)(const int id, void *extra);
+
+/** @brief Callback for each overlapping pair found by jo_collision_sap_find_pairs()
+ *  @param id1 Lowest box index
+ *  @param id2 Highest box index
+ */
+typedef void (*jo_collision_pair_callback)(const int id1, const int id2, void *extra);
+
+/** @brief Uniform grid
+ *  @remarks Cleared and filled again each frame, then queried by AABB
+ */
+typedef struct
+{
+    int                 left;
+    int                 top;
+    int                 columns;
+    int                 rows;
+    int                 object_count;
+    int                 max_objects;
+    int                 entry_count;
+    int                 max_entries;
+    short               *cells;
+    short               *entry_next;
+    short               *entry_object;
+    jo_aabb             *boxes;
+    int                 *ids;
+    unsigned short      *stamps;
+    unsigned short      stamp;
+}                       jo_collision_grid;
+
+/** @brief Sweep and prune along the vertical axis
+ *  @remarks The box order is kept between frames so sorting is almost free when objects barely move
+ */
+typedef struct
+{
+    int                 count;
+    int                 capacity;
+    unsigned short      *order;
+    short               *keys;
+}                       jo_collision_sap;
+
+/** @brief Check if two AABB overlap
+ *  @param a First box
+ *  @param b Second box
+ *  @return true if boxes overlap
+ */
+static  __jo_force_inline bool      jo_aabb_intersect(const jo_aabb * const a, const jo_aabb * const b)
+{
+    return (jo_square_intersect(a->x, a->y, a->width, a->height, b->x, b->y, b->width, b->height));
+}
+
+/** @brief Init a grid covering an area and reserve its storage
+ *  @param grid Grid
+ *  @param left Left of the area in pixel
+ *  @param top Top of the area in pixel
+ *  @param width Width of the area in pixel
+ *  @param height Height of the area in pixel
+ *  @param max_objects Max object count (up to 32767)
+ *  @param max_entries Max (object, cell) pair count (up to 32767), an object larger than a cell uses more than one entry
+ *  @return true if the storage has been allocated otherwise false
+ *  @remarks Objects outside the area are stored in the border cells
+ */
+bool                                jo_collision_grid_init(jo_collision_grid * const grid, const int left, const int top, const int width, const int height,
+                                                           const int max_objects, const int max_entries);
+
+/** @brief Free grid storage
+ *  @param grid Grid
+ */
+void                                jo_collision_grid_destroy(jo_collision_grid * const grid);
+
+/** @brief Remove all objects (call it each frame before adding objects)
+ *  @param grid Grid
+ */
+void                                jo_collision_grid_clear(jo_collision_grid * const grid);
+
+/** @brief Add an object
+ *  @param grid Grid
+ *  @param box Object bounding box
+ *  @param id User value given back to jo_collision_callback (entity index for instance)
+ *  @return false if the grid is full
+ */
+bool                                jo_collision_grid_add(jo_collision_grid * const grid, const jo_aabb * const box, const int id);
+
+/** @brief Clear the grid then add an array of boxes (ids are array indexes)
+ *  @param grid Grid
+ *  @param boxes Bounding boxes
+ *  @param count Box count
+ */
+void                                jo_collision_grid_build(jo_collision_grid * const grid, const jo_aabb * const boxes, const int count);
+
+/** @brief Call the callback for each object that overlaps the box
+ *  @param grid Grid
+ *  @param box Query bounding box
+ *  @param callback Callback (each object is reported once)
+ *  @param extra Extra data passed to the callback
+ *  @return true if the callback stopped the query
+ */
+bool                                jo_collision_grid_query(jo_collision_grid * const grid, const jo_aabb * const box, jo_collision_callback callback, void *extra);
+
+/** @brief Init a sweep and prune and reserve its storage
+ *  @param sap Sweep and prune
+ *  @param capacity Max box count (up to 65535)
+ *  @return true if the storage has been allocated otherwise false
+ */
+bool                                jo_collision_sap_init(jo_collision_sap * const sap, const int capacity);
+
+/** @brief Free sweep and prune storage
+ *  @param sap Sweep and prune
+ */
+void                                jo_collision_sap_destroy(jo_collision_sap * const sap);
+
+/** @brief Sort boxes by top edge (insertion sort from the previous order) then report each overlapping pair
+ *  @param sap Sweep and prune
+ *  @param boxes Bounding boxes (box index = id given to the callback)
+ *  @param count Box count
+ *  @param callback Callback
+ *  @param extra Extra data passed to the callback
+ *  @remarks Boxes with a width or a height lower or equal to 0 are ignored (handy for dead entities)
+ *  @remarks Use the same index for the same object from one frame to the next
+ */
+void                                jo_collision_sap_find_pairs(jo_collision_sap * const sap, const jo_aabb * const boxes, const int count,
+                                                                jo_collision_pair_callback callback, void *extra);
+
+#endif /* !__JO_COLLISION_H__ */
+
+/*
+** END OF FILE
+*/
@@ -58,6 +58,30 @@ typedef void	(*jo_event_callback)(void);
 /** @brief Function prototype for jo_core_exec_on_slave() */
 typedef void	(*jo_slave_callback)(void);
 
+/** @brief Max update steps run by jo_core_run() in a single frame to catch up dropped frames (can be overridden with -DJO_CORE_MAX_UPDATE_STEPS=...)
+ *  @remarks When the game is even later, the simulation slows down instead of never catching up
+ */
+#ifndef JO_CORE_MAX_UPDATE_STEPS
+# define JO_CORE_MAX_UPDATE_STEPS   (4)
+#endif
+
+#ifdef JO_DEBUG
+
+/** @brief Game loop callback profile (see jo_core_get_callback_profile()) */
+typedef struct
+{
+    /** @brief Call count */
+    unsigned int        calls;
+    /** @brief CPU cycles of the last call (FRC ticks converted with the clock select mode of the call) */
+    unsigned int        last_cycles;
+    /** @brief CPU cycles of all calls */
+    unsigned long long  total_cycles;
+    /** @brief Allocations done by all calls (jo_malloc(), jo_calloc(), etc) */
+    unsigned int        malloc_count;
+}                       jo_core_callback_profile;
+
+#endif
+
 /** @brief Init the engine
  *  @param back_color Default background color (colors.h)
  *  @warning Must be the first function called in jo_main()
@@ -85,6 +109,44 @@ int     jo_core_add_callback(const jo_event_callback callback);
  */
 void    jo_core_remove_callback(const int event_id);
 
+/** @brief Add a callback in the update phase of the game loop on main CPU (fixed timestep mode)
+ *  @param callback Function name with no parameters and no return value
+ *  @return Event Id (usefull for jo_core_remove_update_callback())
+ *  @remarks As soon as an update callback exists, jo_core_run() calls update callbacks (and storyboards) once per elapsed frame,
+ *  so the simulation speed doesn't depend on the rendering time. Callbacks added with jo_core_add_callback() become the render phase,
+ *  they are called once per displayed frame and should not change the game state
+ *  @remarks Rendering of the frames that had to be caught up is skipped, only the last one is displayed
+ *  @remarks Gamepad key down/up events are only seen by the first update step of a frame (and by the render phase when it is the only step)
+ *  @warning Don't use jo_get_ticks() in fixed timestep mode (both use the FRC timer)
+ */
+int     jo_core_add_update_callback(const jo_event_callback callback);
+
+/** @brief Remove a callback from the update phase of the game loop
+ *  @param event_id Value returned by jo_core_add_update_callback()
+ */
+void    jo_core_remove_update_callback(const int event_id);
+
+/** @brief Get the update step count of the current frame (fixed timestep mode)
+ *  @return 1 unless the previous frame took longer than expected
+ */
+int     jo_core_get_update_steps(void);
+
+#ifdef JO_DEBUG
+
+/** @brief Get the profile of a game loop callback on main CPU
+ *  @param event_id Value returned by jo_core_add_callback() or jo_core_add_update_callback()
+ *  @return Profile or JO_NULL if the callback doesn't exist
+ */
+const jo_core_callback_profile  *jo_core_get_callback_profile(const int event_id);
+
+/** @brief Print the average time and allocations per call of each game loop callback on main CPU
+ *  @param x Horizontal position (in characters) of the first line
+ *  @param y Vertical position (in characters) of the first line
+ */
+void    jo_core_print_callback_profiles(const int x, const int y);
+
+#endif
+
 /** @brief Add a callback in the game loop on slave CPU
  *  @param callback Function name with no parameters and no return value
  *  @warning Must be called before jo_core_run()
@@ -138,6 +200,12 @@ static  __jo_force_inline char * jo_get_last_error(void)
 
 #ifdef JO_DEBUG
 
+/** @brief Get the time spent to register memory zones in jo_core_init()
+ *  @return FRC ticks (1 tick = 128 CPU cycles, about 4.5 microseconds), 0xFFFF if it took more than ~0.29 second
+ *  @remarks Build with JO_MALLOC_ZERO_FILL_AT_STARTUP to compare with memory zones cleared at boot
+ */
+unsigned int        jo_core_get_memory_init_ticks(void);
+
 /** @brief Dump VDP1 registers
  */
 void                jo_dump_vdp1_registers(void);
@@ -0,0 +1,225 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/** @file entity.h
+ *  @author Johannes Fetz
+ *
+ *  @brief Jo Engine Fixed-capacity entity store (structure of arrays)
+ *  @bug No known bugs.
+ */
+
+#ifndef __JO_ENTITY_H__
+# define __JO_ENTITY_H__
+
+/** @brief Returned by jo_entity_spawn() when the store is full */
+# define JO_ENTITY_NONE         (-1)
+
+/** @brief Entity store
+ *  @remarks Each attribute has its own array so update loops read memory sequentially
+ *  @remarks Positions and velocities are fixed numbers (JO_FIXED_1 = 1 pixel)
+ */
+typedef struct
+{
+    int                 capacity;
+    int                 count;
+    int                 *x;
+    int                 *y;
+    int                 *vx;
+    int                 *vy;
+    short               *sprite;
+    short               *hp;
+    unsigned int        *alive;
+    unsigned short      *free_slots;
+    int                 free_count;
+}                       jo_entity_store;
+
+/** @brief Callback for jo_entity_store_foreach() */
+typedef void (*jo_entity_callback)(jo_entity_store * const store, const int index);
+
+/** @brief Callback for jo_entity_store_any() */
+typedef bool (*jo_entity_any_callback)(jo_entity_store * const store, const int index, void *extra);
+
+/** @brief Init an entity store and reserve its storage
+ *  @param store Entity store
+ *  @param capacity Max entity count (up to 65535)
+ *  @return true if the storage has been allocated otherwise false
+ */
+bool                                jo_entity_store_init(jo_entity_store * const store, const int capacity);
+
+/** @brief Free entity store storage
+ *  @param store Entity store
+ */
+void                                jo_entity_store_destroy(jo_entity_store * const store);
+
+/** @brief Kill all entities
+ *  @param store Entity store
+ */
+void                                jo_entity_store_clear(jo_entity_store * const store);
+
+/** @brief Add velocity to position of every alive entity
+ *  @param store Entity store
+ */
+void                                jo_entity_store_move(jo_entity_store * const store);
+
+/** @brief Kill every alive entity outside the rectangle
+ *  @param store Entity store
+ *  @param left Left boundary in pixel
+ *  @param top Top boundary in pixel
+ *  @param right Right boundary in pixel
+ *  @param bottom Bottom boundary in pixel
+ *  @return Killed entity count
+ */
+int                                 jo_entity_store_kill_outside(jo_entity_store * const store, const int left, const int top, const int right, const int bottom);
+
+/** @brief Move every alive entity then kill it if it is outside the rectangle (one pass, same result as jo_entity_store_move() then jo_entity_store_kill_outside())
+ *  @param store Entity store
+ *  @param left Left boundary in pixel
+ *  @param top Top boundary in pixel
+ *  @param right Right boundary in pixel
+ *  @param bottom Bottom boundary in pixel
+ *  @return Killed entity count
+ */
+int                                 jo_entity_store_move_and_kill_outside(jo_entity_store * const store, const int left, const int top, const int right, const int bottom);
+
+/** @brief Kill every alive entity inside the rectangle (batch collision with small entities like bullets)
+ *  @param store Entity store
+ *  @param left Left boundary in pixel
+ *  @param top Top boundary in pixel
+ *  @param right Right boundary in pixel (excluded)
+ *  @param bottom Bottom boundary in pixel (excluded)
+ *  @return Killed entity count
+ */
+int                                 jo_entity_store_kill_inside(jo_entity_store * const store, const int left, const int top, const int right, const int bottom);
+
+/** @brief Check if an entity is alive
+ *  @param store Entity store
+ *  @param index Entity index
+ *  @return true if the entity is alive
+ */
+static  __jo_force_inline bool      jo_entity_is_alive(const jo_entity_store * const store, const int index)
+{
+    return ((store->alive[JO_DIV_BY_32(index)] & (1U << (index & 31))) != 0);
+}
+
+/** @brief Create an entity
+ *  @param store Entity store
+ *  @param x Horizontal position (fixed)
+ *  @param y Vertical position (fixed)
+ *  @param vx Horizontal velocity (fixed)
+ *  @param vy Vertical velocity (fixed)
+ *  @param sprite_id Sprite Id
+ *  @return Entity index or JO_ENTITY_NONE if the store is full
+ */
+static  __jo_force_inline int       jo_entity_spawn(jo_entity_store * const store, const int x, const int y, const int vx, const int vy, const int sprite_id)
+{
+    int     index;
+
+    if (store->free_count <= 0)
+        return (JO_ENTITY_NONE);
+    index = store->free_slots[--store->free_count];
+    store->x[index] = x;
+    store->y[index] = y;
+    store->vx[index] = vx;
+    store->vy[index] = vy;
+    store->sprite[index] = sprite_id;
+    JO_ZERO(store->hp[index]);
+    store->alive[JO_DIV_BY_32(index)] |= (1U << (index & 31));
+    ++store->count;
+    return (index);
+}
+
+/** @brief Destroy an entity
+ *  @param store Entity store
+ *  @param index Entity index
+ */
+static  __jo_force_inline void      jo_entity_kill(jo_entity_store * const store, const int index)
+{
+    if (!jo_entity_is_alive(store, index))
+        return;
+    store->alive[JO_DIV_BY_32(index)] &= ~(1U << (index & 31));
+    store->free_slots[store->free_count++] = index;
+    --store->count;
+}
+
+/** @brief Get horizontal position in pixel
+ *  @param store Entity store
+ *  @param index Entity index
+ */
+static  __jo_force_inline int       jo_entity_get_x(const jo_entity_store * const store, const int index)
+{
+    return (JO_DIV_BY_65536(store->x[index]));
+}
+
+/** @brief Get vertical position in pixel
+ *  @param store Entity store
+ *  @param index Entity index
+ */
+static  __jo_force_inline int       jo_entity_get_y(const jo_entity_store * const store, const int index)
+{
+    return (JO_DIV_BY_65536(store->y[index]));
+}
+
+/** @brief Iterate on alive entities
+ *  @param store Entity store
+ *  @param callback callback for each alive entity (it can kill any entity)
+ */
+static  __jo_force_inline void      jo_entity_store_foreach(jo_entity_store * const store, jo_entity_callback callback)
+{
+    unsigned int    bits;
+    int             word;
+    int             index;
+
+    for (JO_ZERO(word); word < JO_DIV_BY_32(store->capacity + 31); ++word)
+        for (bits = store->alive[word], index = JO_MULT_BY_32(word); bits; bits >>= 1, ++index)
+            if ((bits & 1) && jo_entity_is_alive(store, index))
+                callback(store, index);
+}
+
+/** @brief Find if any alive entity satisfy the condition (callback)
+ *  @param store Entity store
+ *  @param extra Extra data passed to the callback
+ *  @param callback callback for each alive entity
+ *  @return true if any entity satisfy the condition otherwise false
+ */
+static  __jo_force_inline bool      jo_entity_store_any(jo_entity_store * const store, jo_entity_any_callback callback, void *extra)
+{
+    unsigned int    bits;
+    int             word;
+    int             index;
+
+    for (JO_ZERO(word); word < JO_DIV_BY_32(store->capacity + 31); ++word)
+        for (bits = store->alive[word], index = JO_MULT_BY_32(word); bits; bits >>= 1, ++index)
+            if ((bits & 1) && jo_entity_is_alive(store, index) && callback(store, index, extra))
+                return (true);
+    return (false);
+}
+
+#endif /* !__JO_ENTITY_H__ */
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,122 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/** @file handle.h
+ *  @author Johannes Fetz
+ *
+ *  @brief Jo Engine Relocatable (handle-based) memory allocation
+ *  @bug No known bugs.
+ */
+
+#ifndef __JO_HANDLE_H__
+# define __JO_HANDLE_H__
+
+/** @brief Bytes moved by the compactor on each frame (you can override it with -DJO_HANDLE_COMPACTION_BUDGET=...) */
+#ifndef JO_HANDLE_COMPACTION_BUDGET
+# define JO_HANDLE_COMPACTION_BUDGET        (4096)
+#endif
+
+/** @brief Invalid handle value (returned by jo_handle_alloc() if it failed) */
+# define JO_INVALID_HANDLE                  (0)
+
+/** @brief Handle on a relocatable memory block */
+typedef unsigned short                      jo_handle;
+
+/** @brief Handle table (internal engine usage) use jo_handle_get() instead
+ *  @warning MC Hammer: don't touch this
+ */
+extern void                                 **__jo_handle_table;
+
+/** @brief Bytes freed inside the handle heap (internal engine usage)
+ *  @warning MC Hammer: don't touch this
+ */
+extern unsigned int                         __jo_handle_hole_bytes;
+
+/** @brief Reserve the relocatable heap
+ *  @param size_in_bytes Heap size
+ *  @param max_handles Max live handles (at most 65535)
+ *  @return true if the heap has been allocated otherwise false
+ *  @remarks Blocks allocated from this heap can be moved by the engine, so holes left by jo_handle_free() are recovered
+ */
+bool                                        jo_handle_heap_init(const unsigned int size_in_bytes, const unsigned int max_handles);
+
+/** @brief Allocate a relocatable block
+ *  @param n Size in bytes
+ *  @return Handle or JO_INVALID_HANDLE if failed
+ *  @remarks Compact the whole heap if the remaining space is too small
+ */
+jo_handle                                   jo_handle_alloc(unsigned int n);
+
+/** @brief Free a relocatable block
+ *  @param handle Handle returned by jo_handle_alloc()
+ */
+void                                        jo_handle_free(const jo_handle handle);
+
+/** @brief Get the current address of a relocatable block
+ *  @param handle Handle returned by jo_handle_alloc()
+ *  @return Block address
+ *  @warning The address is valid until the next call to jo_handle_compact_step() (done by jo_core_run() between two frames) so never keep it
+ */
+static  __jo_force_inline void              *jo_handle_get(const jo_handle handle)
+{
+    return (__jo_handle_table[handle]);
+}
+
+/** @brief Slide live blocks down over the holes
+ *  @param max_bytes_moved Budget (the step stops once this amount of memory has been moved)
+ *  @return true if there are still holes to recover
+ *  @remarks At least one block is moved on each call, even if it is bigger than the budget
+ *  @remarks Called by jo_core_run() on each frame with JO_HANDLE_COMPACTION_BUDGET
+ */
+bool                                        jo_handle_compact_step(unsigned int max_bytes_moved);
+
+/** @brief Compact the whole relocatable heap now
+ */
+static  __jo_force_inline void              jo_handle_compact(void)
+{
+    while (jo_handle_compact_step(0xFFFFFFFF))
+        ;
+}
+
+/** @brief Check if the compactor has some work to do
+ *  @return true if holes are waiting to be recovered
+ */
+static  __jo_force_inline bool              jo_handle_compaction_pending(void)
+{
+    return (__jo_handle_hole_bytes != 0);
+}
+
+/** @brief Get available memory in the relocatable heap (including holes)
+ *  @return Free bytes
+ */
+unsigned int                                jo_handle_heap_free_bytes(void);
+
+#endif /* !__JO_HANDLE_H__ */
+
+/*
+** END OF FILE
+*/
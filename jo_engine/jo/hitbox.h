@@ -34,6 +34,60 @@
 #ifndef __JO_HITBOX_H__
 # define __JO_HITBOX_H__
 
+/*
+** HITBOX DEFINITION
+*/
+
+/** @brief Maximum hitbox count per sprite in a hitbox file (can be overridden with -DJO_HITBOX_MAX_BOXES_PER_SPRITE=...) */
+#ifndef JO_HITBOX_MAX_BOXES_PER_SPRITE
+# define JO_HITBOX_MAX_BOXES_PER_SPRITE     (8)
+#endif
+
+/** @brief Restore the default hitbox of a sprite (the full sprite rectangle)
+ *  @param sprite_id Sprite Id
+ */
+void                            jo_hitbox_reset(const int sprite_id);
+
+/** @brief Set a single hitbox for a sprite
+ *  @param sprite_id Sprite Id
+ *  @param x Horizontal offset of the hitbox from the top left corner of the sprite
+ *  @param y Vertical offset of the hitbox from the top left corner of the sprite
+ *  @param width Width of the hitbox
+ *  @param height Height of the hitbox
+ */
+void                            jo_hitbox_set(const int sprite_id, const int x, const int y, const int width, const int height);
+
+/** @brief Set several hitboxes for a sprite
+ *  @param sprite_id Sprite Id
+ *  @param boxes Hitboxes (offsets from the top left corner of the sprite)
+ *  @param count Hitbox count
+ *  @return true on success otherwise false (the previous hitboxes are kept)
+ */
+bool                            jo_hitbox_set_boxes(const int sprite_id, const jo_aabb * const boxes, const int count);
+
+#ifdef JO_COMPILE_WITH_FS_SUPPORT
+
+/** @brief Load hitboxes from a file (usually next to the TGA file)
+ *  @param first_sprite_id First sprite Id (jo_sprite_add_tga_tileset() return value for a tileset)
+ *  @param sub_dir Sub directory name (use JO_ROOT_DIR if the file is on the root directory)
+ *  @param filename Filename (upper case and shorter as possible like "SHIP.HIT")
+ *  @return true on success otherwise false
+ *  @remarks One hitbox per line: "<tile index> <x> <y> <width> <height>", lines of the same tile must follow each other
+ */
+bool                            jo_hitbox_load_from_file(const int first_sprite_id, const char * const sub_dir, const char * const filename);
+
+#endif /* !JO_COMPILE_WITH_FS_SUPPORT */
+
+/** @brief (internal engine usage)
+ *  @warning MC Hammer: don't touch this
+ */
+bool                            __jo_hitbox_detection_boxes(const jo_sprite_hitbox * const hitbox, const int x, const int y,
+                                                            const int left, const int top, const int right, const int bottom);
+
+/*
+** HITBOX DETECTION
+*/
+
 /** @brief Fast method to get if two sprites intersects (HitBox processing)
  *  @param sprite_id1 Sprite Id of the first sprite
  *  @param x1 Horizontal position of the first sprite
@@ -45,15 +99,24 @@
  */
 static  __jo_force_inline bool	jo_hitbox_detection(const int sprite_id1, const int x1, const int y1, const int sprite_id2, const int x2, const int y2)
 {
-    return jo_square_intersect(x1 - JO_DIV_BY_2(__jo_sprite_def[sprite_id1].width),
-                               y1 - JO_DIV_BY_2(__jo_sprite_def[sprite_id1].height),
-                               __jo_sprite_def[sprite_id1].width,
-                               __jo_sprite_def[sprite_id1].height,
-                               x2 - JO_DIV_BY_2(__jo_sprite_def[sprite_id2].width),
-                               y2 - JO_DIV_BY_2(__jo_sprite_def[sprite_id2].height),
-                               __jo_sprite_def[sprite_id2].width,
-                               __jo_sprite_def[sprite_id2].height);
+    const jo_sprite_hitbox      *hitbox1;
+    const jo_sprite_hitbox      *hitbox2;
+    register int                i;
 
+    hitbox1 = &__jo_sprite_hitbox[sprite_id1];
+    hitbox2 = &__jo_sprite_hitbox[sprite_id2];
+    if (x1 + hitbox1->bounds.right <= x2 + hitbox2->bounds.left || x2 + hitbox2->bounds.right <= x1 + hitbox1->bounds.left ||
+        y1 + hitbox1->bounds.bottom <= y2 + hitbox2->bounds.top || y2 + hitbox2->bounds.bottom <= y1 + hitbox1->bounds.top)
+        return (false);
+    if (hitbox2->boxes == JO_NULL)
+        return (hitbox1->boxes == JO_NULL ||
+                __jo_hitbox_detection_boxes(hitbox1, x1, y1, x2 + hitbox2->bounds.left, y2 + hitbox2->bounds.top,
+                                            x2 + hitbox2->bounds.right, y2 + hitbox2->bounds.bottom));
+    for (JO_ZERO(i); i < hitbox2->count; ++i)
+        if (__jo_hitbox_detection_boxes(hitbox1, x1, y1, x2 + hitbox2->boxes[i].left, y2 + hitbox2->boxes[i].top,
+                                        x2 + hitbox2->boxes[i].right, y2 + hitbox2->boxes[i].bottom))
+            return (true);
+    return (false);
 }
 
 /** @brief Fast method to get if the sprite intersects with the box (HitBox processing)
@@ -68,15 +131,62 @@ static  __jo_force_inline bool	jo_hitbox_detection(const int sprite_id1, const i
  */
 static  __jo_force_inline bool	jo_hitbox_detection_custom_boundaries(const int sprite_id1, const int x1, const int y1, const int x2, const int y2, const int w2, const int h2)
 {
-    return jo_square_intersect(x1 - JO_DIV_BY_2(__jo_sprite_def[sprite_id1].width),
-                               y1 - JO_DIV_BY_2(__jo_sprite_def[sprite_id1].height),
-                               __jo_sprite_def[sprite_id1].width,
-                               __jo_sprite_def[sprite_id1].height,
-                               x2 - JO_DIV_BY_2(w2),
-                               y2 - JO_DIV_BY_2(h2),
-                               w2,
-                               h2);
+    const jo_sprite_hitbox      *hitbox1;
+    int                         left;
+    int                         top;
+
+    hitbox1 = &__jo_sprite_hitbox[sprite_id1];
+    left = x2 - JO_DIV_BY_2(w2);
+    top = y2 - JO_DIV_BY_2(h2);
+    if (x1 + hitbox1->bounds.right <= left || left + w2 <= x1 + hitbox1->bounds.left ||
+        y1 + hitbox1->bounds.bottom <= top || top + h2 <= y1 + hitbox1->bounds.top)
+        return (false);
+    return (hitbox1->boxes == JO_NULL || __jo_hitbox_detection_boxes(hitbox1, x1, y1, left, top, left + w2, top + h2));
+}
 
+/** @brief Pixel-perfect test between two sprites using their collision masks
+ *  @param sprite_id1 Sprite Id of the first sprite
+ *  @param x1 Horizontal position of the first sprite
+ *  @param y1 Vertical position of the first sprite
+ *  @param horizontal_flip1 true if the first sprite is drawn horizontally flipped
+ *  @param sprite_id2 Sprite Id of the second sprite
+ *  @param x2 Horizontal position of the second sprite
+ *  @param y2 Vertical position of the second sprite
+ *  @param horizontal_flip2 true if the second sprite is drawn horizontally flipped
+ *  @return true if at least one opaque pixel of both sprites overlaps
+ *  @remarks Masks are built at load time after jo_sprite_enable_collision_masks(), a sprite without mask is treated as fully opaque
+ *  @remarks Vertical flip, scale and rotation are not handled
+ */
+bool                            jo_hitbox_pixel_overlap(const int sprite_id1, const int x1, const int y1, const bool horizontal_flip1,
+                                                        const int sprite_id2, const int x2, const int y2, const bool horizontal_flip2);
+
+/** @brief Get the bounding box of the hitboxes of a sprite (for jo_collision_grid_add() or jo_collision_grid_query())
+ *  @param sprite_id Sprite Id
+ *  @param x Horizontal position of the sprite
+ *  @param y Vertical position of the sprite
+ *  @param box Result
+ */
+static  __jo_force_inline void	jo_hitbox_get_aabb(const int sprite_id, const int x, const int y, jo_aabb * const box)
+{
+    box->x = x + __jo_sprite_hitbox[sprite_id].bounds.left;
+    box->y = y + __jo_sprite_hitbox[sprite_id].bounds.top;
+    box->width = __jo_sprite_hitbox[sprite_id].bounds.right - __jo_sprite_hitbox[sprite_id].bounds.left;
+    box->height = __jo_sprite_hitbox[sprite_id].bounds.bottom - __jo_sprite_hitbox[sprite_id].bounds.top;
+}
+
+/** @brief Get the bounding box of a custom boundaries centered on a position (for jo_collision_grid_add() or jo_collision_grid_query())
+ *  @param x Horizontal position of the box
+ *  @param y Vertical position of the box
+ *  @param w Width of the box
+ *  @param h Height of the box
+ *  @param box Result
+ */
+static  __jo_force_inline void	jo_hitbox_get_custom_aabb(const int x, const int y, const int w, const int h, jo_aabb * const box)
+{
+    box->x = x - JO_DIV_BY_2(w);
+    box->y = y - JO_DIV_BY_2(h);
+    box->width = w;
+    box->height = h;
 }
 
 #endif /* !__JO_HITBOX_H__ */
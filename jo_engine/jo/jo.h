@@ -50,8 +50,16 @@
 #include "tools.h"
 #include "vdp1_command_pipeline.h"
 #include "malloc.h"
+#include "pool.h"
+#include "arena.h"
+#include "handle.h"
 #include "colors.h"
 #include "list.h"
+#include "array.h"
+#include "ring.h"
+#include "entity.h"
+#include "bullet.h"
+#include "collision.h"
 #include "input.h"
 #include "fs.h"
 #include "audio.h"
@@ -66,6 +74,7 @@
 #include "physics.h"
 #include "3d.h"
 #include "backup.h"
+#include "replay.h"
 #include "video.h"
 #include "effects.h"
 #include "font.h"
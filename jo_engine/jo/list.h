@@ -66,6 +66,33 @@ struct              __jo_node
     jo_node         *next;
 };
 
+/** @brief Number of nodes in the first chunk allocated by a list (can be overridden with -DJO_LIST_FIRST_CHUNK_NODES=...)
+ *  @remarks Each new chunk doubles the list capacity (up to JO_LIST_MAX_CHUNK_NODES), set both to 1 to get back one allocation per node
+ */
+#ifndef JO_LIST_FIRST_CHUNK_NODES
+# define JO_LIST_FIRST_CHUNK_NODES  (4)
+#endif
+
+/** @brief Max number of nodes in one chunk (can be overridden with -DJO_LIST_MAX_CHUNK_NODES=...) */
+#ifndef JO_LIST_MAX_CHUNK_NODES
+# define JO_LIST_MAX_CHUNK_NODES    (256)
+#endif
+
+/** @brief Contiguous node storage owned by a list, nodes follow the header
+ *  @remarks The chunk goes back to the heap as soon as all its nodes are free
+ *  @warning MC Hammer: don't touch this
+ */
+typedef struct __jo_list_node_chunk jo_list_node_chunk;
+
+struct                      __jo_list_node_chunk
+{
+    jo_list_node_chunk      *prev;
+    jo_list_node_chunk      *next;
+    jo_node                 *free_nodes;
+    unsigned short          capacity;
+    unsigned short          used;
+};
+
 /** @brief List struct */
 typedef struct
 {
@@ -73,6 +100,12 @@ typedef struct
     jo_node                 *first;
     jo_node                 *last;
     jo_malloc_behaviour     allocation_behaviour;
+    jo_pool                 *pool;
+    jo_list_node_chunk      *chunks;/* chunks with free nodes first */
+    jo_list_node_chunk      *last_chunk;
+    unsigned int            chunk_capacity;
+    int                     iteration_depth;
+    jo_node                 *dead_nodes;
 }                           jo_list;
 
 /** @brief Init a list
@@ -103,6 +136,26 @@ static  __jo_force_inline jo_node   *jo_list_add_ptr(jo_list * const list, void
  */
 void                                jo_list_remove(jo_list * const list, const jo_node * const node_to_delete);
 
+/** @brief Tag set on the prev pointer of the nodes removed during jo_list_foreach_mutable() or jo_list_sweep()
+ *  @warning MC Hammer: don't touch this
+ */
+# define JO_LIST_DEAD_NODE                  (1)
+
+/** @brief Check if the node has been removed during the current jo_list_foreach_mutable() or jo_list_sweep()
+ *  @param node Node
+ *  @return true if the node has been removed
+ */
+static  __jo_force_inline bool      jo_list_is_dead_node(const jo_node * const node)
+{
+    return (((unsigned int)node->prev & JO_LIST_DEAD_NODE) != 0);
+}
+
+/** @brief Free nodes removed during jo_list_foreach_mutable() or jo_list_sweep()
+ *  @param list List
+ *  @warning MC Hammer: don't touch this
+ */
+void                                __jo_list_free_dead_nodes(jo_list * const list);
+
 /** @brief Free node pointer and remove the item from the list
  *  @param list List
  *  @param node_to_delete Node to remove
@@ -113,6 +166,12 @@ static  __jo_force_inline void	    jo_list_free_and_remove(jo_list * const list,
     jo_list_remove(list, node_to_delete);
 }
 
+/** @brief Give node chunks back to the heap
+ *  @param list List (must be empty)
+ *  @remarks Called by jo_list_clear() and jo_list_free_and_clear(), chunks are also released one by one when their last node is removed
+ */
+void                                jo_list_release_chunks(jo_list * const list);
+
 /** @brief Free node pointers and remove all item
  *  @param list List
  */
@@ -123,6 +182,7 @@ static  __jo_force_inline void	    jo_list_free_and_clear(jo_list * const list)
         if (list->first->data.ptr != JO_NULL) jo_free(list->first->data.ptr);
         jo_list_remove(list, list->first);
     }
+    jo_list_release_chunks(list);
 }
 
 /** @brief Free and remove the last item from the list
@@ -163,6 +223,7 @@ static  __jo_force_inline void      jo_list_remove_first(jo_list * const list)
 static  __jo_force_inline void	    jo_list_clear(jo_list * const list)
 {
     while (list->first != JO_NULL) jo_list_remove(list, list->first);
+    jo_list_release_chunks(list);
 }
 
 /** @brief Get first item
@@ -191,6 +252,33 @@ static  __jo_force_inline void	    jo_list_foreach(jo_list * const list, jo_node
     for (tmp = list->first; tmp != JO_NULL; tmp = tmp->next) callback(tmp);
 }
 
+/** @brief Iterate on the list, the callback can remove any node of this list
+ *  @param list List
+ *  @param callback callback for each node
+ *  @remarks Removed nodes are freed all at once when the iteration ends
+ */
+static  __jo_force_inline void	    jo_list_foreach_mutable(jo_list * const list, jo_node_callback callback)
+{
+    jo_node *tmp;
+    ++list->iteration_depth;
+    for (tmp = list->first; tmp != JO_NULL; tmp = tmp->next) if (!jo_list_is_dead_node(tmp)) callback(tmp);
+    if (--list->iteration_depth == 0 && list->dead_nodes != JO_NULL) __jo_list_free_dead_nodes(list);
+}
+
+/** @brief Remove all elements of the list that satisfy the condition (callback)
+ *  @param list List
+ *  @param extra Extra data passed to the callback
+ *  @param callback callback for each node, return true to remove the node
+ *  @remarks The callback can also remove other nodes of this list
+ */
+static  __jo_force_inline void	    jo_list_sweep(jo_list * const list, jo_node_any_callback callback, void *extra)
+{
+    jo_node *tmp;
+    ++list->iteration_depth;
+    for (tmp = list->first; tmp != JO_NULL; tmp = tmp->next) if (!jo_list_is_dead_node(tmp) && callback(tmp, extra)) jo_list_remove(list, tmp);
+    if (--list->iteration_depth == 0 && list->dead_nodes != JO_NULL) __jo_list_free_dead_nodes(list);
+}
+
 /** @brief Find if any element of the list satisfy the condition (callback)
  *  @param list List
  *  @param extra Extra data passed to the callback
@@ -204,7 +292,7 @@ static  __jo_force_inline bool	    jo_list_any(jo_list * const list, jo_node_any
     return false;
 }
 
-/** @brief Set list memory allocation behaviour
+/** @brief Set list memory allocation behaviour (used for node chunks)
  *  @param list List pointer
  *  @param behaviour Allocation behaviour
  */
@@ -213,6 +301,16 @@ static  __jo_force_inline void      jo_list_set_allocation_behaviour(jo_list * c
     list->allocation_behaviour = behaviour;
 }
 
+/** @brief Allocate list nodes from a pool instead of jo_malloc_with_behaviour()
+ *  @param list List pointer (must be empty)
+ *  @param pool Pool initialized with jo_pool_init_for_type(pool, jo_node, capacity) or NULL to use the heap again
+ *  @remarks jo_list_add() returns NULL when the pool is full
+ */
+static  __jo_force_inline void      jo_list_set_pool(jo_list * const list, jo_pool * const pool)
+{
+    list->pool = pool;
+}
+
 /** @brief Remove the first item on the list that match DATA
  *  @param list List
  *  @param data Node DATA
@@ -239,6 +337,116 @@ static  __jo_force_inline void	    jo_list_remove_all_value(jo_list * const list
         ;
 }
 
+/*
+** INTRUSIVE LIST
+*/
+
+/** @brief Link embedded in a user struct for jo_intrusive_list (8 bytes)
+ *  @remarks Put it as first member of the struct so JO_LIST_ENTRY() costs nothing
+ */
+typedef struct __jo_list_link jo_list_link;
+
+/** @brief Callback for jo_intrusive_list_foreach() */
+typedef void (*jo_list_link_callback)(jo_list_link *link);
+
+/** @brief Callback for jo_intrusive_list_any() */
+typedef bool (*jo_list_link_any_callback)(jo_list_link *link, void *extra);
+
+/** @brief Link struct */
+struct              __jo_list_link
+{
+    jo_list_link    *prev;
+    jo_list_link    *next;
+};
+
+/** @brief Intrusive list struct
+ *  @remarks Add and remove never allocate: the caller owns the memory of each item
+ */
+typedef struct
+{
+    int                     count;
+    jo_list_link            *first;
+    jo_list_link            *last;
+}                           jo_intrusive_list;
+
+/** @brief Get the struct that contains the link
+ *  @param LINK Link pointer
+ *  @param TYPE Type of the struct that contains the link
+ *  @param MEMBER Name of the link member in TYPE
+ */
+#define JO_LIST_ENTRY(LINK, TYPE, MEMBER)   ((TYPE *)((char *)(LINK) - __builtin_offsetof(TYPE, MEMBER)))
+
+/** @brief Init an intrusive list
+ *  @param list List pointer
+ */
+static  __jo_force_inline void      jo_intrusive_list_init(jo_intrusive_list * const list)
+{
+    JO_ZERO(list->count);
+    list->first = JO_NULL;
+    list->last = JO_NULL;
+}
+
+/** @brief Add an item at the end of the list
+ *  @param list List
+ *  @param link Link embedded in the item (must not be on another list)
+ */
+void                                jo_intrusive_list_add(jo_intrusive_list * const list, jo_list_link * const link);
+
+/** @brief Remove an item from the list
+ *  @param list List
+ *  @param link Link embedded in the item
+ *  @remarks The item itself is not freed
+ */
+void                                jo_intrusive_list_remove(jo_intrusive_list * const list, jo_list_link * const link);
+
+/** @brief Remove all item
+ *  @param list List
+ *  @remarks Items are not freed
+ */
+static  __jo_force_inline void      jo_intrusive_list_clear(jo_intrusive_list * const list)
+{
+    jo_intrusive_list_init(list);
+}
+
+/** @brief Get first item
+ *  @param list List
+ */
+static  __jo_force_inline jo_list_link  *jo_intrusive_list_first(jo_intrusive_list * const list)
+{
+    return (list->first);
+}
+
+/** @brief Get last item
+ *  @param list List
+ */
+static  __jo_force_inline jo_list_link  *jo_intrusive_list_last(jo_intrusive_list * const list)
+{
+    return (list->last);
+}
+
+/** @brief Iterate on the list
+ *  @param list List
+ *  @param callback callback for each link
+ */
+static  __jo_force_inline void	    jo_intrusive_list_foreach(jo_intrusive_list * const list, jo_list_link_callback callback)
+{
+    jo_list_link *tmp;
+    for (tmp = list->first; tmp != JO_NULL; tmp = tmp->next) callback(tmp);
+}
+
+/** @brief Find if any element of the list satisfy the condition (callback)
+ *  @param list List
+ *  @param extra Extra data passed to the callback
+ *  @param callback callback for each link
+ *  @return true if any element satisfy the condition otherwise false
+ */
+static  __jo_force_inline bool	    jo_intrusive_list_any(jo_intrusive_list * const list, jo_list_link_any_callback callback, void *extra)
+{
+    jo_list_link *tmp;
+    for (tmp = list->first; tmp != JO_NULL; tmp = tmp->next) if (callback(tmp, extra)) return true;
+    return false;
+}
+
 #endif /* !__JO_LIST_H__ */
 
 /*
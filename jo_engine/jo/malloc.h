@@ -71,12 +71,48 @@ typedef enum
     JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE
 }       jo_malloc_behaviour;
 
+/** @brief Allocator statistics
+ *  @remarks Sizes include the 8 bytes block header
+ */
+typedef struct
+{
+    unsigned int    total_bytes;
+    unsigned int    used_bytes;
+    unsigned int    peak_used_bytes;
+    unsigned int    block_count;
+    unsigned int    free_block_count;
+    /** @brief Allocation count since the start */
+    unsigned int    malloc_count;
+    /** @brief Free count since the start */
+    unsigned int    free_count;
+}                   jo_memory_stats;
+
+/** @brief Memory zone placement hint */
+typedef enum
+{
+    /** @brief Default: Main RAM first (hot and small objects), then RAM cartridge */
+    JO_ZONE_PREFER_FAST,
+    /** @brief RAM cartridge first (large one-shot buffers: files, PCM, images, ring buffers), then Main RAM */
+    JO_ZONE_PREFER_BULK
+}       jo_malloc_zone_placement;
+
+/** @brief dynamic memory allocator with specific behaviour and zone placement
+ *  @param n Segment size
+ *  @param behaviour Allocation Behaviour
+ *  @param placement Memory zone placement hint (same as JO_ZONE_PREFER_FAST without RAM cartridge)
+ *  @return a pointer to the allocated memory or NULL if failed
+ */
+void	        *jo_malloc_with_placement(unsigned int n, const jo_malloc_behaviour behaviour, const jo_malloc_zone_placement placement);
+
 /** @brief dynamic memory allocator with specific behaviour
  *  @param n Segment size
  *  @param behaviour Allocation Behaviour
  *  @return a pointer to the allocated memory or NULL if failed
  */
-void	        *jo_malloc_with_behaviour(unsigned int n, const jo_malloc_behaviour behaviour);
+static  __jo_force_inline void	*jo_malloc_with_behaviour(unsigned int n, const jo_malloc_behaviour behaviour)
+{
+    return jo_malloc_with_placement(n, behaviour, JO_ZONE_PREFER_FAST);
+}
 
 /** @brief dynamic memory allocator
  *  @param n Segment size
@@ -91,6 +127,34 @@ static  __jo_force_inline void	*jo_malloc(unsigned int n)
  */
 void	        jo_free(const void * const p);
 
+/** @brief dynamic memory allocator with specific behaviour (memory is set to zero)
+ *  @param n Segment size
+ *  @param behaviour Allocation Behaviour
+ *  @return a pointer to the allocated memory or NULL if failed
+ */
+void            *jo_calloc_with_behaviour(const unsigned int n, const jo_malloc_behaviour behaviour);
+
+/** @brief dynamic memory allocator (memory is set to zero)
+ *  @param n Segment size
+ *  @return a pointer to the allocated memory or NULL if failed
+ */
+static  __jo_force_inline void	*jo_calloc(const unsigned int n)
+{
+    return jo_calloc_with_behaviour(n, JO_FAST_ALLOCATION);
+}
+
+/** @brief Clear a slice of memory zones that have not been zero-filled yet
+ *  @param max_bytes Max bytes to clear (ignored when JO_MALLOC_DMA_ZERO_FILL is defined: a whole zone is cleared by the SH2 DMA channel 1 in background)
+ *  @return true if there is still memory to clear
+ *  @remarks Called by jo_core_run() while waiting for the VBLANK (with SGL, before slSynch() while the frame has time left)
+ */
+bool            jo_memory_zero_fill_step(unsigned int max_bytes);
+
+/** @brief Get the number of bytes that have not been zero-filled yet
+ *  @return Pending bytes (0 once every zone is cleared)
+ */
+unsigned int    jo_memory_zero_fill_pending_bytes(void);
+
 #ifdef JO_COMPILE_WITH_RAM_CARD_SUPPORT
 
 /** @brief Get the extended RAM cartridge type if available
@@ -103,21 +167,41 @@ static  __jo_force_inline jo_extended_ram_cartridge_type      jo_get_extended_ra
 
 #endif
 
-#ifdef JO_DEBUG
-
 /** @brief Get memory usage percent
  *  @return memory usage percent
+ *  @remarks O(1): computed from the allocator counters (available in release build)
  *  @remarks jo_printf(0, 0, "Dynamic memory usage: %d%%  ", jo_memory_usage_percent());
  */
-int             jo_memory_usage_percent(void);
+int                     jo_memory_usage_percent(void);
 
-/** @brief Get memory fragmentation (Number of fragment in memory)
+/** @brief Get memory fragmentation (Number of free fragment in memory)
+ *  @remarks Adjacent free blocks are merged by jo_free() so this is the number of holes left between used blocks
  *  @return Memory fragmentation
  *  @remarks jo_printf(0, 0, "Dynamic memory fragmentation: %d%%  ", jo_memory_fragmentation());
  */
-int             jo_memory_fragmentation(void);
+int                     jo_memory_fragmentation(void);
 
-#endif
+/** @brief Get the number of memory zones (Main RAM + RAM cartridge banks)
+ *  @return Zone count
+ */
+int                     jo_memory_zone_count(void);
+
+/** @brief Get allocator statistics for all zones
+ *  @return Statistics (updated on each malloc/free, never recomputed)
+ */
+const jo_memory_stats   *jo_memory_get_stats(void);
+
+/** @brief Get allocator statistics for one zone
+ *  @param zone Zone index (0 is the Main RAM)
+ *  @return Statistics (updated on each malloc/free, never recomputed)
+ */
+const jo_memory_stats   *jo_memory_get_zone_stats(const int zone);
+
+/** @brief Display memory usage, peak usage, block count and free block count (3 lines)
+ *  @param x Horizontal position from top left screen corner
+ *  @param y Vertical position from top left screen corner
+ */
+void                    jo_memory_print_stats(const int x, const int y);
 
 #endif /* !__JO_MALLOC_H__ */
 
@@ -224,11 +224,12 @@ extern int JoCosLookupTable[360];
  */
 # define JO_SWAP(A, B)                      { (A) = (A) ^ (B); (B) = (A) ^ (B); (A) = (A) ^ (B); }
 
-/** @brief Compute percent (100 / TOTAL * (TOTAL - FREE))
- *  @param TOTAL Total
+/** @brief Compute percent ((TOTAL - FREE) * 100 / TOTAL)
+ *  @param TOTAL Total (must be lower than 42MB)
  *  @param FREE Free
+ *  @remarks Integer only (no float emulation on SH2)
  */
-# define JO_PERCENT_USED(TOTAL, FREE)       (int)(100.0f / (float)(TOTAL) * (float)((TOTAL) - (FREE)))
+# define JO_PERCENT_USED(TOTAL, FREE)       (int)((((unsigned int)((TOTAL) - (FREE))) * 100U) / (unsigned int)(TOTAL))
 
 /** @brief Square computation (x)
  *  @param A operand
@@ -284,6 +285,16 @@ static  __jo_force_inline bool	jo_square_intersect(const int x1, const int y1, c
  */
 int                             jo_random(int max);
 
+/** @brief Set the seed of jo_random() (same seed = same random sequence)
+ *  @param seed Seed (1 to 2147483646)
+ */
+void                            jo_random_set_seed(int seed);
+
+/** @brief Get the current seed of jo_random()
+ *  @return Seed
+ */
+int                             jo_random_get_seed(void);
+
 /** @brief Get a random number with a specific multiple
  *  @param max maximum value
  *  @param multiple multiple
@@ -307,10 +318,16 @@ unsigned int                    jo_sqrt(unsigned int value);
  */
 static  __jo_force_inline float jo_sqrtf(float value)
 {
-    unsigned int i = *(unsigned int*)(void *)&value;
-    i += 127 << 23;
-    i >>= 1;
-    return *(float*)(void *)&i;
+    union
+    {
+        float           f;
+        unsigned int    i;
+    }                   bits;
+
+    bits.f = value;
+    bits.i += 127 << 23;
+    bits.i >>= 1;
+    return bits.f;
 }
 
 /*
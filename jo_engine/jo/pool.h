@@ -0,0 +1,125 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/** @file pool.h
+ *  @author Johannes Fetz
+ *
+ *  @brief Jo Engine Fixed-size object pool
+ *  @bug No known bugs.
+ */
+
+#ifndef __JO_POOL_H__
+# define __JO_POOL_H__
+
+/** @brief Fixed-size object pool
+ *  @remarks Storage is reserved once by jo_pool_init(), then jo_pool_alloc() and jo_pool_free() are O(1) and never touch the heap
+ */
+typedef struct
+{
+    unsigned int    item_size;
+    unsigned int    capacity;
+    unsigned int    count;
+    unsigned char   *storage;
+    void            *free_list;
+}                   jo_pool;
+
+/** @brief Init a pool and reserve its storage
+ *  @param pool Pool pointer
+ *  @param item_size Size of one item in bytes
+ *  @param capacity Max item count
+ *  @return true if the storage has been allocated otherwise false
+ */
+bool                                jo_pool_init(jo_pool * const pool, unsigned int item_size, const unsigned int capacity);
+
+/** @brief Init a pool for a specific type
+ *  @param pool Pool pointer
+ *  @param type Item type
+ *  @param capacity Max item count
+ */
+# define jo_pool_init_for_type(pool, type, capacity)     jo_pool_init((pool), sizeof(type), (capacity))
+
+/** @brief Release all items at once (storage is kept)
+ *  @param pool Pool pointer
+ */
+void                                jo_pool_reset(jo_pool * const pool);
+
+/** @brief Free pool storage
+ *  @param pool Pool pointer
+ */
+void                                jo_pool_destroy(jo_pool * const pool);
+
+/** @brief Get an item from the pool
+ *  @param pool Pool pointer
+ *  @return a pointer to the item or NULL if the pool is full
+ */
+static  __jo_force_inline void      *jo_pool_alloc(jo_pool * const pool)
+{
+    void    *item;
+
+    item = pool->free_list;
+    if (item == JO_NULL)
+        return JO_NULL;
+    pool->free_list = *((void **)item);
+    ++pool->count;
+    return item;
+}
+
+/** @brief Give back an item to the pool
+ *  @param pool Pool pointer
+ *  @param item Item returned by jo_pool_alloc()
+ */
+static  __jo_force_inline void      jo_pool_free(jo_pool * const pool, const void * const item)
+{
+    *((void **)item) = pool->free_list;
+    pool->free_list = (void *)item;
+    --pool->count;
+}
+
+/** @brief Check if the item has been allocated from the pool
+ *  @param pool Pool pointer
+ *  @param item Item pointer
+ *  @return true if the item belongs to the pool storage
+ */
+static  __jo_force_inline bool      jo_pool_contains(const jo_pool * const pool, const void * const item)
+{
+    return ((unsigned char *)item >= pool->storage && (unsigned char *)item < pool->storage + pool->item_size * pool->capacity);
+}
+
+/** @brief Check if the pool is full
+ *  @param pool Pool pointer
+ *  @return true if no more item is available
+ */
+static  __jo_force_inline bool      jo_pool_is_full(const jo_pool * const pool)
+{
+    return (pool->free_list == JO_NULL);
+}
+
+#endif /* !__JO_POOL_H__ */
+
+/*
+** END OF FILE
+*/
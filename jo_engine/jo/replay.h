@@ -0,0 +1,162 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/** @file replay.h
+ *  @author Johannes Fetz
+ *
+ *  @brief Jo Engine Gamepad recording and deterministic replay
+ *  @bug No known bugs.
+ */
+
+#ifndef __JO_REPLAY_H__
+# define __JO_REPLAY_H__
+
+/** @brief Stream header size in bytes: magic ("JORP"), jo_random() seed, frame count and run count (big endian) */
+# define JO_REPLAY_HEADER_SIZE          (16)
+
+/** @brief Size in bytes of a run: frame count then pressed keys of gamepad 1 and 2 (big endian) */
+# define JO_REPLAY_RUN_SIZE             (6)
+
+/** @brief Replay state */
+typedef enum
+{
+    JoReplayStopped = 0,
+    JoReplayRecording = 1,
+    JoReplayPlaying = 2
+}                                       jo_replay_state;
+
+/** @brief Input replay
+ *  @remarks The stream stores pressed keys of both gamepads, run-length encoded (one run per change), key down/up events are computed again on playback
+ *  @remarks The stream is the same in memory, on backup RAM or in a host file
+ */
+typedef struct
+{
+    jo_replay_state                     state;
+    unsigned char                       *stream;
+    unsigned int                        length;
+    unsigned int                        capacity;
+    unsigned int                        frame;
+    unsigned int                        frame_count;
+    unsigned int                        cursor;
+    unsigned int                        run_left;
+    unsigned short                      previous[2];
+}                                       jo_replay;
+
+/** @brief Current replay (internal engine usage)
+ *  @warning MC Hammer: don't touch this
+ */
+extern jo_replay                        *__jo_replay;
+
+/** @brief Start recording gamepads
+ *  @param replay Replay
+ *  @param max_runs Max run count (a run is a sequence of frames with the same pressed keys)
+ *  @return true on success otherwise false
+ *  @remarks The jo_random() seed is stored in the stream
+ *  @remarks The replay is updated by jo_core_run() after each frame, in fixed timestep mode it runs one update step per frame
+ *  @warning The replay must be zero initialized before the first use (global or static variable)
+ */
+bool                                    jo_replay_start_recording(jo_replay * const replay, const unsigned int max_runs);
+
+/** @brief Start replaying a stream in place of gamepads
+ *  @param replay Replay
+ *  @param stream Stream (from jo_replay_get_stream(), jo_fs_read_file(), etc.) it is not copied
+ *  @param length Stream length in bytes
+ *  @return true on success, false if the stream is invalid (bad magic number, truncated stream or empty run)
+ *  @remarks The jo_random() seed is restored from the stream
+ */
+bool                                    jo_replay_start_playing(jo_replay * const replay, unsigned char * const stream, const unsigned int length);
+
+/** @brief Stop recording or playing
+ *  @param replay Replay
+ */
+void                                    jo_replay_stop(jo_replay * const replay);
+
+/** @brief Free the stream of a recorded (or loaded) replay
+ *  @param replay Replay
+ */
+void                                    jo_replay_free(jo_replay * const replay);
+
+/** @brief Get the stream of a replay (for saving it)
+ *  @param replay Replay
+ *  @param length Stream length in bytes
+ *  @return Stream
+ */
+static  __jo_force_inline unsigned char *jo_replay_get_stream(const jo_replay * const replay, unsigned int * const length)
+{
+    *length = replay->length;
+    return (replay->stream);
+}
+
+/** @brief Get the current frame of the replay
+ *  @param replay Replay
+ *  @return Frame number from the start of the recording or playback
+ */
+static  __jo_force_inline unsigned int  jo_replay_get_frame(const jo_replay * const replay)
+{
+    return (replay->frame);
+}
+
+/** @brief Check if a replay is playing
+ *  @param replay Replay
+ *  @return true if the replay is playing (false when the stream is over)
+ */
+static  __jo_force_inline bool          jo_replay_is_playing(const jo_replay * const replay)
+{
+    return (replay->state == JoReplayPlaying);
+}
+
+/** @brief Record or play one frame (internal engine usage)
+ *  @warning MC Hammer: don't touch this
+ */
+void                                    jo_replay_update(void);
+
+#ifdef JO_COMPILE_WITH_BACKUP_SUPPORT
+
+/** @brief Save a recorded replay to the backup device
+ *  @param replay Replay
+ *  @param backup_device Backup device
+ *  @param fname File name (max 11 characters not NULL)
+ *  @return true if succeed
+ */
+bool                                    jo_replay_save_to_backup(jo_replay * const replay, const jo_backup_device backup_device, const char * const fname);
+
+/** @brief Load a replay from the backup device and start playing it
+ *  @param replay Replay
+ *  @param backup_device Backup device
+ *  @param fname File name (max 11 characters not NULL)
+ *  @return true if succeed
+ *  @remarks Call jo_replay_free() when you are done
+ */
+bool                                    jo_replay_play_from_backup(jo_replay * const replay, const jo_backup_device backup_device, const char * const fname);
+
+#endif /* !JO_COMPILE_WITH_BACKUP_SUPPORT */
+
+#endif /* !__JO_REPLAY_H__ */
+
+/*
+** END OF FILE
+*/
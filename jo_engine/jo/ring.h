@@ -0,0 +1,173 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+/** @file ring.h
+ *  @author Johannes Fetz
+ *
+ *  @brief Jo Engine Fixed-capacity ring buffer (FIFO queue)
+ *  @bug No known bugs.
+ */
+
+#ifndef __JO_RING_H__
+# define __JO_RING_H__
+
+/** @brief Callback for jo_ring_foreach() */
+typedef void (*jo_ring_callback)(void *item);
+
+/** @brief Callback for jo_ring_any() */
+typedef bool (*jo_ring_any_callback)(void *item, void *extra);
+
+/** @brief Fixed-capacity ring buffer
+ *  @remarks Storage is reserved once by jo_ring_init(), then jo_ring_push() and jo_ring_pop() are O(1) and never touch the heap
+ */
+typedef struct
+{
+    int             count;
+    int             capacity;
+    int             head;
+    unsigned int    item_size;
+    unsigned char   *items;
+}                   jo_ring;
+
+/** @brief Init a ring buffer and reserve its storage
+ *  @param ring Ring pointer
+ *  @param item_size Size of one item in bytes
+ *  @param capacity Max item count
+ *  @return true if the storage has been allocated otherwise false
+ */
+bool                                jo_ring_init(jo_ring * const ring, unsigned int item_size, const int capacity);
+
+/** @brief Init a ring buffer for a specific type
+ *  @param ring Ring pointer
+ *  @param type Item type
+ *  @param capacity Max item count
+ */
+# define jo_ring_init_for_type(ring, type, capacity)     jo_ring_init((ring), sizeof(type), (capacity))
+
+/** @brief Free ring storage
+ *  @param ring Ring pointer
+ */
+void                                jo_ring_destroy(jo_ring * const ring);
+
+/** @brief Get an item
+ *  @param ring Ring pointer
+ *  @param index Item index from the oldest item (0) to the newest (count - 1)
+ *  @return Item pointer
+ */
+static  __jo_force_inline void      *jo_ring_at(const jo_ring * const ring, int index)
+{
+    index += ring->head;
+    if (index >= ring->capacity)
+        index -= ring->capacity;
+    return (ring->items + index * ring->item_size);
+}
+
+/** @brief Check if the ring is full
+ *  @param ring Ring pointer
+ *  @return true if no more item can be pushed
+ */
+static  __jo_force_inline bool      jo_ring_is_full(const jo_ring * const ring)
+{
+    return (ring->count >= ring->capacity);
+}
+
+/** @brief Add an item at the end of the queue
+ *  @param ring Ring pointer
+ *  @return Pointer to the new (uninitialized) item or NULL if the ring is full
+ */
+static  __jo_force_inline void      *jo_ring_push(jo_ring * const ring)
+{
+    if (jo_ring_is_full(ring))
+        return (JO_NULL);
+    return (jo_ring_at(ring, ring->count++));
+}
+
+/** @brief Get the oldest item without removing it
+ *  @param ring Ring pointer
+ *  @return Item pointer or NULL if the ring is empty
+ */
+static  __jo_force_inline void      *jo_ring_peek(const jo_ring * const ring)
+{
+    if (ring->count <= 0)
+        return (JO_NULL);
+    return (ring->items + ring->head * ring->item_size);
+}
+
+/** @brief Remove the oldest item
+ *  @param ring Ring pointer
+ *  @return Item pointer (valid until the next jo_ring_push()) or NULL if the ring is empty
+ */
+static  __jo_force_inline void      *jo_ring_pop(jo_ring * const ring)
+{
+    void    *item;
+
+    item = jo_ring_peek(ring);
+    if (item == JO_NULL)
+        return (JO_NULL);
+    if (++ring->head >= ring->capacity)
+        JO_ZERO(ring->head);
+    --ring->count;
+    return (item);
+}
+
+/** @brief Remove all items
+ *  @param ring Ring pointer
+ */
+static  __jo_force_inline void      jo_ring_clear(jo_ring * const ring)
+{
+    JO_ZERO(ring->count);
+    JO_ZERO(ring->head);
+}
+
+/** @brief Iterate on the ring from the oldest item to the newest
+ *  @param ring Ring pointer
+ *  @param callback callback for each item
+ */
+static  __jo_force_inline void	    jo_ring_foreach(jo_ring * const ring, jo_ring_callback callback)
+{
+    int i;
+    for (JO_ZERO(i); i < ring->count; ++i) callback(jo_ring_at(ring, i));
+}
+
+/** @brief Find if any item of the ring satisfy the condition (callback)
+ *  @param ring Ring pointer
+ *  @param extra Extra data passed to the callback
+ *  @param callback callback for each item
+ *  @return true if any item satisfy the condition otherwise false
+ */
+static  __jo_force_inline bool	    jo_ring_any(jo_ring * const ring, jo_ring_any_callback callback, void *extra)
+{
+    int i;
+    for (JO_ZERO(i); i < ring->count; ++i) if (callback(jo_ring_at(ring, i), extra)) return true;
+    return false;
+}
+
+#endif /* !__JO_RING_H__ */
+
+/*
+** END OF FILE
+*/
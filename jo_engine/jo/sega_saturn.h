@@ -120,8 +120,14 @@
 # define JO_VDP1_USER_AREA_SIZE             (0x71D38)
 /** @brief VDP1 user area end address */
 # define JO_VDP1_USER_AREA_END_ADDR         (0x25C7FEF8)
-/** @brief VDP1 Sprite base address */
+/** @brief VDP1 Sprite base address
+ *  @remarks Without SGL, the two command lists of vdp1_command_pipeline.c are below it (JO_VDP1_MAX_COMMANDS)
+ */
+#if JO_COMPILE_USING_SGL
 # define JO_VDP1_TEXTURE_DEF_BASE_ADDRESS   (0x10000)
+#else
+# define JO_VDP1_TEXTURE_DEF_BASE_ADDRESS   (0x14000)
+#endif
 
 /*
  __      _______  _____    ___
@@ -159,7 +165,10 @@
        \----------|----------|----------|----------|----------|----------|----------|---------*/
 # define JO_VDP2_TVMD        (*(volatile unsigned short *)0x25F80000) // 0x8110 0x8120
 # define JO_VDP2_EXTEN       (*(volatile unsigned short *)0x25F80002) // 0x0
+/* Can be overridden with -DJO_VDP2_TVSTAT=... to run jo_core_run() without a VDP2 (host builds) */
+#ifndef JO_VDP2_TVSTAT
 # define JO_VDP2_TVSTAT      (*(volatile unsigned short *)0x25F80004) // N/A
+#endif
 
 /* 180006 - r/w - VRSIZE - VRAM Size
  bit-> /----15----|----14----|----13----|----12----|----11----|----10----|----09----|----08----\
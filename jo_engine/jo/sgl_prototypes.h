@@ -288,6 +288,7 @@ extern  Bool   slDispSprite(FIXED *, SPR_ATTR *attr, ANGLE) ;
 extern  void    slScrPosNbg1(FIXED x,FIXED y) ;
 extern  void    slZoomNbg1(FIXED x,FIXED y) ;
 extern void    slDMACopy(void *, void *, Uint32) ;
+extern void    slDMAWait(void) ;
 extern  void    slBack1ColSet(void *, Uint16) ;
 extern  void    slCharNbg0(Uint16 type,Uint16 size) ;
 extern  void    slCharNbg1(Uint16 type,Uint16 size) ;
@@ -44,6 +44,11 @@
 #include "math.h"
 #include "colors.h"
 
+/** @brief Max sprites displayed with jo_sprite_retain() at the same time (can be overridden with -DJO_MAX_RETAINED_SPRITES=...) */
+#ifndef JO_MAX_RETAINED_SPRITES
+# define JO_MAX_RETAINED_SPRITES        (64)
+#endif
+
 /** @brief Current displayed sprite attribute (internal engine usage)
  *  @warning MC Hammer: don't touch this
  */
@@ -60,6 +65,18 @@ extern jo_texture_definition        __jo_sprite_def[JO_MAX_SPRITE];
  *  @warning MC Hammer: don't touch this
  */
 extern jo_picture_definition        __jo_sprite_pic[JO_MAX_SPRITE];
+/** @brief Precomputed hitbox edges of each sprite (internal engine usage)
+ *  @warning MC Hammer: don't touch this
+ */
+extern jo_sprite_hitbox             __jo_sprite_hitbox[JO_MAX_SPRITE];
+/** @brief 1-bpp collision masks in work RAM, one bit per pixel, MSB first (internal engine usage)
+ *  @warning MC Hammer: don't touch this
+ */
+extern unsigned int                 *__jo_sprite_mask[JO_MAX_SPRITE];
+/** @brief (internal engine usage)
+ *  @warning MC Hammer: don't touch this
+ */
+extern bool                         __jo_sprite_build_collision_masks;
 /** @brief (internal engine usage)
  *  @warning MC Hammer: don't touch this
  */
@@ -174,6 +191,34 @@ static  __jo_force_inline void	jo_sprite_disable_dark_filter(void)
     __jo_sprite_attributes.effect &= ~(2);
 }
 
+/*
+** Collision masks
+*/
+/** @brief Build a 1-bpp collision mask for every sprite added after this call (see jo_hitbox_pixel_overlap())
+ *  @remarks Works with jo_sprite_add(), jo_sprite_add_tga(), tileset loaders and 8 bits images (color index 0 is transparent)
+ *  @remarks Costs ((width + 31) / 32) * height * 4 bytes of work RAM per sprite
+ */
+static  __jo_force_inline void	jo_sprite_enable_collision_masks(void)
+{
+    __jo_sprite_build_collision_masks = true;
+}
+
+/** @brief Stop building collision masks for sprites added after this call
+ */
+static  __jo_force_inline void	jo_sprite_disable_collision_masks(void)
+{
+    __jo_sprite_build_collision_masks = false;
+}
+
+/** @brief Check if the sprite has a collision mask
+ *  @param sprite_id Sprite Id
+ *  @return true if the sprite has a collision mask
+ */
+static  __jo_force_inline bool	jo_sprite_has_collision_mask(const int sprite_id)
+{
+    return (__jo_sprite_mask[sprite_id] != JO_NULL);
+}
+
 /*
 ** Half transparency
 */
@@ -288,7 +333,7 @@ static  __jo_force_inline void	jo_sprite_restore_sprite_scale(void)
  *  @param sprite_id Sprite Id
  *  @param x Horizontal position from the center of the screen
  *  @param y Vertical position from the center of the screen
- *  @param z Z index (depth)
+ *  @param z Z index (depth, bigger is farther)
  *  @param angle Angle (Z axe)
  */
 static  __jo_force_inline void	jo_sprite_draw3D_and_rotate(const int sprite_id, const int x, const int y, const int z, const int angle)
@@ -301,7 +346,7 @@ static  __jo_force_inline void	jo_sprite_draw3D_and_rotate(const int sprite_id,
  *  @param sprite_id Sprite Id
  *  @param x Horizontal position from the center of the screen
  *  @param y Vertical position from the center of the screen
- *  @param z Z index (depth))
+ *  @param z Z index (depth, bigger is farther)
  */
 static  __jo_force_inline void	jo_sprite_draw3D(const int sprite_id, const int x, const int y, const int z)
 {
@@ -313,7 +358,7 @@ static  __jo_force_inline void	jo_sprite_draw3D(const int sprite_id, const int x
  *  @param sprite_id Sprite Id returned by jo_sprite_add(), jo_sprite_add_tga() or jo_sprite_add_image_pack()
  *  @param x Horizontal position from the top left corner
  *  @param y Vertical position from the top left corner
- *  @param z Z index (depth)
+ *  @param z Z index (depth, bigger is farther)
  *  @param angle Angle (Z axe)
  */
 static  __jo_force_inline void	jo_sprite_draw3D_and_rotate2(const int sprite_id, const int x, const int y, const int z, const int angle)
@@ -326,7 +371,7 @@ static  __jo_force_inline void	jo_sprite_draw3D_and_rotate2(const int sprite_id,
  *  @param sprite_id Sprite Id returned by jo_sprite_add(), jo_sprite_add_tga() or jo_sprite_add_image_pack()
  *  @param x Horizontal position from the top left corner
  *  @param y Vertical position from the top left corner
- *  @param z Z index (depth)
+ *  @param z Z index (depth, bigger is farther)
  */
 static  __jo_force_inline void	jo_sprite_draw3D2(const int sprite_id, const int x, const int y, const int z)
 {
@@ -334,6 +379,64 @@ static  __jo_force_inline void	jo_sprite_draw3D2(const int sprite_id, const int
     jo_sprite_draw(sprite_id, &__jo_sprite_pos, false, false);
 }
 
+/*
+** Retained sprites
+*/
+/** @brief Display a sprite every frame until jo_sprite_release() is called, without calling jo_sprite_draw3D() each frame
+ *  @param sprite_id Sprite Id returned by jo_sprite_add(), jo_sprite_add_tga() or jo_sprite_add_image_pack()
+ *  @param x Horizontal position from the center of the screen
+ *  @param y Vertical position from the center of the screen
+ *  @param z Z index (depth, bigger is farther)
+ *  @return Retained instance or -1 if JO_MAX_RETAINED_SPRITES is reached
+ *  @remarks Current sprite attributes (transparency, flip, etc) are kept. Without SGL, only the words of the VDP1 command that changed are uploaded
+ *  @warning Scale, rotation and gouraud shading are not supported
+ */
+int     jo_sprite_retain(const int sprite_id, const int x, const int y, const int z);
+
+/** @brief Move a retained sprite
+ *  @param instance Retained instance returned by jo_sprite_retain()
+ *  @param x Horizontal position from the center of the screen
+ *  @param y Vertical position from the center of the screen
+ */
+void    jo_sprite_retained_set_position(const int instance, const int x, const int y);
+
+/** @brief Change the depth of a retained sprite
+ *  @param instance Retained instance returned by jo_sprite_retain()
+ *  @param z Z index (depth, bigger is farther)
+ */
+void    jo_sprite_retained_set_depth(const int instance, const int z);
+
+/** @brief Change the sprite displayed by a retained sprite (animation)
+ *  @param instance Retained instance returned by jo_sprite_retain()
+ *  @param sprite_id Sprite Id (ex: jo_get_anim_sprite())
+ */
+void    jo_sprite_retained_set_sprite(const int instance, const int sprite_id);
+
+/** @brief Flip a retained sprite
+ *  @param instance Retained instance returned by jo_sprite_retain()
+ *  @param horizontal Horizontal flip
+ *  @param vertical Vertical flip
+ */
+void    jo_sprite_retained_set_flip(const int instance, const bool horizontal, const bool vertical);
+
+/** @brief Show or hide a retained sprite
+ *  @param instance Retained instance returned by jo_sprite_retain()
+ *  @param visible true to display the sprite
+ */
+void    jo_sprite_retained_set_visible(const int instance, const bool visible);
+
+/** @brief Stop displaying a retained sprite
+ *  @param instance Retained instance returned by jo_sprite_retain() (-1 is ignored)
+ */
+void    jo_sprite_release(const int instance);
+
+#if JO_COMPILE_USING_SGL
+/** @brief Draw retained sprites (internal engine usage)
+ *  @warning MC Hammer: don't touch this
+ */
+void    __jo_sprite_draw_retained(void);
+#endif
+
 /*
 ** Some helper to get pixel color in texture
 */
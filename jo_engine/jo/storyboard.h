@@ -47,6 +47,7 @@
  */
 typedef struct
 {
+    jo_list_link                link;
     jo_3d_object_attributes     *user;
     int                         dx;
     int                         dy;
@@ -57,6 +58,7 @@ typedef struct
 /** @brief Object animation definition */
 typedef struct
 {
+    jo_list_link        link;
     bool                disabled;
     unsigned int        count;
     unsigned short      frame;
@@ -75,8 +77,9 @@ typedef struct
   */
 typedef struct
 {
-    jo_list             objects;
-    jo_list             animations;
+    jo_list_link        link;
+    jo_intrusive_list   objects;
+    jo_intrusive_list   animations;
     bool                repeat;
     bool                pause;
 }                       jo_storyboard;
@@ -115,9 +118,10 @@ jo_animation                                *jo_storyboard_create_animation(jo_s
   * @param animation Animation to destroy
   * @see jo_storyboard_create_animation()
   */
-static  __jo_force_inline void              jo_storyboard_destroy_animation(jo_storyboard * const storyboard, const jo_animation * const animation)
+static  __jo_force_inline void              jo_storyboard_destroy_animation(jo_storyboard * const storyboard, jo_animation * const animation)
 {
-    jo_list_remove_first_value(&storyboard->animations, (jo_list_data)(void *)animation);
+    jo_intrusive_list_remove(&storyboard->animations, &animation->link);
+    jo_free(animation);
 }
 
 /*
@@ -179,11 +183,12 @@ static  __jo_force_inline void              jo_storyboard_add_object(jo_storyboa
     jo_storyboard_object_cache              *tmp = (jo_storyboard_object_cache *)jo_malloc_with_behaviour(sizeof(*tmp), JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE);
 
     tmp->user = (jo_3d_object_attributes *)object;
-    tmp->dx = JO_MULT_BY_8(tmp->user->x);
-    tmp->dy = JO_MULT_BY_8(tmp->user->y);
+    /* object may only be a jo_pos3D */
+    tmp->dx = JO_MULT_BY_8(((const jo_pos3D *)object)->x);
+    tmp->dy = JO_MULT_BY_8(((const jo_pos3D *)object)->y);
     JO_ZERO(tmp->current_cos);
     JO_ZERO(tmp->current_sin);
-    jo_list_add_ptr(&storyboard->objects, tmp);
+    jo_intrusive_list_add(&storyboard->objects, &tmp->link);
 }
 
 /** @brief Remove object from storyboard
@@ -192,11 +197,12 @@ static  __jo_force_inline void              jo_storyboard_add_object(jo_storyboa
   */
 static  __jo_force_inline void                  jo_storyboard_remove_object(jo_storyboard *const storyboard, const void * const object)
 {
-    jo_node *tmp;
+    jo_list_link *tmp;
     for (tmp = storyboard->objects.first; tmp != JO_NULL; tmp = tmp->next)
-        if (((jo_storyboard_object_cache *)tmp->data.ptr)->user == object)
+        if (JO_LIST_ENTRY(tmp, jo_storyboard_object_cache, link)->user == object)
         {
-            jo_list_remove(&storyboard->objects, tmp);
+            jo_intrusive_list_remove(&storyboard->objects, tmp);
+            jo_free(JO_LIST_ENTRY(tmp, jo_storyboard_object_cache, link));
             return ;
         }
 }
@@ -212,10 +218,10 @@ static  __jo_force_inline void                  jo_storyboard_remove_object(jo_s
   */
 static  __jo_force_inline jo_storyboard_object_cache        *jo_storyboard_get_object_cache(jo_storyboard *const storyboard, const void * const object)
 {
-    jo_node *tmp;
+    jo_list_link *tmp;
     for (tmp = storyboard->objects.first; tmp != JO_NULL; tmp = tmp->next)
-        if (((jo_storyboard_object_cache *)tmp->data.ptr)->user == object)
-            return ((jo_storyboard_object_cache *)tmp->data.ptr);
+        if (JO_LIST_ENTRY(tmp, jo_storyboard_object_cache, link)->user == object)
+            return (JO_LIST_ENTRY(tmp, jo_storyboard_object_cache, link));
     return (JO_NULL);
 }
 
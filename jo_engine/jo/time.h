@@ -36,7 +36,9 @@
 # define __JO_TIME_H__
 
 # define JO_TIME_CKS_32_MODE        (1)
+# define JO_TIME_CKS_128_MODE       (2)
 # define JO_TIME_M_CKS              (3)
+# define JO_TIME_OVF                (2)
 
 typedef enum
 {
@@ -64,6 +66,11 @@ static  __jo_force_inline int jo_time_get_frc(void)
 {
     return (jo_time_peek_byte(RegisterHighFRC) << 8 | jo_time_peek_byte(RegisterLowFRC));
 }
+/** @brief CPU cycles between two FRC increments in the current clock select (CKS) mode (8, 32 or 128) */
+static  __jo_force_inline unsigned int jo_time_get_frc_cycles_per_tick(void)
+{
+    return (8 << ((jo_time_peek_byte(RegisterTCR) & JO_TIME_M_CKS) << 1));
+}
 static  __jo_force_inline void jo_time_set_frc(unsigned char reg)
 {
     jo_time_poke_byte(RegisterHighFRC, reg >> 8);
@@ -72,6 +79,7 @@ static  __jo_force_inline void jo_time_set_frc(unsigned char reg)
 
 /** @brief get ticks count
  *  @return ticks count from jo_core_run()
+ *  @warning Each call resets the FRC timer: calling it from a game loop callback breaks the profiling of this callback (JO_DEBUG)
  */
 unsigned int    jo_get_ticks(void);
 
@@ -49,6 +49,19 @@ static  __jo_force_inline unsigned short        jo_swap_endian_ushort(unsigned s
     return ((((value) >> 8) & 0xff) | (((value) & 0xff) << 8));
 }
 
+/** @brief Convert a little endian unsigned short (TGA and BIN files) to the CPU byte order
+  * @param value Unsigned short read from the file
+  * @return Same as jo_swap_endian_ushort() on the Saturn, unchanged on little endian hosts (host benchmarks)
+  */
+static  __jo_force_inline unsigned short        jo_little_endian_to_ushort(unsigned short value)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return (value);
+#else
+    return (jo_swap_endian_ushort(value));
+#endif
+}
+
 /** @brief Swap unsigned int endian
   * @param value Little or Big endian unsigned int
   * @return Endian swapped unsigned int
@@ -145,6 +158,14 @@ static  __jo_force_inline void        jo_dma_copy(void *src, void *dest, unsigne
 #endif
 }
 
+/** @brief Wait for the end of the last jo_dma_copy()
+  * @todo Implementation without SGL
+  */
+static  __jo_force_inline void        jo_dma_wait(void)
+{
+    slDMAWait();
+}
+
 /** @brief NULL implementation
  */
 # define JO_NULL                            ((void *)0)
@@ -135,6 +135,26 @@ typedef struct
     unsigned short      size;
 }                       jo_texture_definition;
 
+/** @brief Hitbox edges relative to the center of the sprite (see jo_hitbox_set()) */
+typedef struct
+{
+    short               left;
+    short               top;
+    short               right;
+    short               bottom;
+}                       jo_hitbox_edges;
+
+/** @brief Sprite hitbox definition */
+typedef struct
+{
+    /** @brief Single hitbox or bounding box of all hitboxes */
+    jo_hitbox_edges     bounds;
+    /** @brief Hitbox count */
+    int                 count;
+    /** @brief Hitboxes (JO_NULL when count is 1, bounds is used instead) */
+    jo_hitbox_edges     *boxes;
+}                       jo_sprite_hitbox;
+
 /** @brief Picture definition */
 typedef struct
 {
@@ -37,7 +37,16 @@
 
 #if !JO_COMPILE_USING_SGL
 
-/** @brief (internal engine usage)
+/** @brief Size of the VDP1 command buffer allocated once by jo_core_init(), one entry is kept for the end command (can be overridden with -DJO_VDP1_MAX_COMMANDS=...)
+ *  @remarks Each command takes 32 bytes in RAM and twice in VDP1 VRAM (double buffered, before JO_VDP1_TEXTURE_DEF_BASE_ADDRESS).
+ *           The last JO_MAX_RETAINED_SPRITES entries are kept for retained commands (see jo_vdp1_retain_command())
+ *           and the first 3 for clipping and local coordinates: 1212 sprites per frame by default
+ */
+#ifndef JO_VDP1_MAX_COMMANDS
+# define JO_VDP1_MAX_COMMANDS                               (1280)
+#endif
+
+/** @brief Number of commands created for the current frame (internal engine usage)
  *  @warning MC Hammer: don't touch this
  */
 extern unsigned int                                 __jo_vdp1_command_index;
@@ -97,8 +106,35 @@ static  __jo_force_inline unsigned short   jo_vdp1_command_to_link(jo_vdp1_comma
     return (command ? (((unsigned int)command - (unsigned int)JO_VDP1_VRAM) / 0x8) : 0);
 }
 
+/** @brief Add a command to the current frame
+ *  @return The new command (sent to the VDP1 by jo_core_run() in a single DMA transfer)
+ *  @remarks When JO_VDP1_MAX_COMMANDS is reached, the command returned is never displayed (reported once per frame by jo_vdp1_flush() in debug)
+ */
 jo_vdp1_command*                jo_vdp1_create_command(void);
 
+/** @brief Reserve a persistent command slot that is displayed every frame until released
+ *  @return Slot index or -1 if JO_MAX_RETAINED_SPRITES is reached
+ *  @remarks Only the words that changed are written to VRAM by jo_core_run()
+ */
+int                             jo_vdp1_retain_command(void);
+
+/** @brief Get a retained command in order to change it
+ *  @param slot Slot index returned by jo_vdp1_retain_command()
+ *  @return The command (sorted by depth using jo_engine_reserved like the others)
+ */
+jo_vdp1_command                 *jo_vdp1_edit_retained_command(const int slot);
+
+/** @brief Show or hide a retained command without releasing it
+ *  @param slot Slot index returned by jo_vdp1_retain_command()
+ *  @param visible true to display the command
+ */
+void                            jo_vdp1_show_retained_command(const int slot, const bool visible);
+
+/** @brief Release a retained command
+ *  @param slot Slot index returned by jo_vdp1_retain_command()
+ */
+void                            jo_vdp1_release_retained_command(const int slot);
+
 #endif
 
 #endif /* !__JO_VDP1_COMMAND_PIPELINE_H__ */
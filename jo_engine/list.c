@@ -39,6 +39,7 @@
 #include "jo/tools.h"
 #include "jo/malloc.h"
 #include "jo/math.h"
+#include "jo/pool.h"
 #include "jo/list.h"
 
 void	jo_list_init(jo_list * const list)
@@ -47,13 +48,176 @@ void	jo_list_init(jo_list * const list)
     list->last = JO_NULL;
     list->first = JO_NULL;
     list->allocation_behaviour = JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE;
+    list->pool = JO_NULL;
+    list->chunks = JO_NULL;
+    list->last_chunk = JO_NULL;
+    JO_ZERO(list->chunk_capacity);
+    JO_ZERO(list->iteration_depth);
+    list->dead_nodes = JO_NULL;
+}
+
+/*
+** NODE CHUNKS
+**
+** Chunks with free nodes are kept at the beginning of list->chunks and full chunks at the end,
+** so jo_list_add() only looks at the first chunk. The next chunk doubles the list capacity
+** (JO_LIST_FIRST_CHUNK_NODES, then the same amount again...) up to JO_LIST_MAX_CHUNK_NODES.
+*/
+
+static  __jo_force_inline jo_node   *__jo_list_chunk_nodes(jo_list_node_chunk * const chunk)
+{
+    return ((jo_node *)(chunk + 1));
+}
+
+static void             __jo_list_unlink_chunk(jo_list * const list, jo_list_node_chunk * const chunk)
+{
+    if (chunk->prev != JO_NULL)
+        chunk->prev->next = chunk->next;
+    else
+        list->chunks = chunk->next;
+    if (chunk->next != JO_NULL)
+        chunk->next->prev = chunk->prev;
+    else
+        list->last_chunk = chunk->prev;
+}
+
+static void             __jo_list_push_chunk_front(jo_list * const list, jo_list_node_chunk * const chunk)
+{
+    chunk->prev = JO_NULL;
+    chunk->next = list->chunks;
+    if (list->chunks != JO_NULL)
+        list->chunks->prev = chunk;
+    else
+        list->last_chunk = chunk;
+    list->chunks = chunk;
+}
+
+static void             __jo_list_push_chunk_back(jo_list * const list, jo_list_node_chunk * const chunk)
+{
+    chunk->next = JO_NULL;
+    chunk->prev = list->last_chunk;
+    if (list->last_chunk != JO_NULL)
+        list->last_chunk->next = chunk;
+    else
+        list->chunks = chunk;
+    list->last_chunk = chunk;
+}
+
+static jo_list_node_chunk   *__jo_list_new_chunk(jo_list * const list)
+{
+    jo_list_node_chunk      *chunk;
+    jo_node                 *nodes;
+    unsigned int            capacity;
+    int                     i;
+
+    capacity = list->chunk_capacity;
+    if (capacity < JO_LIST_FIRST_CHUNK_NODES)
+        capacity = JO_LIST_FIRST_CHUNK_NODES;
+    else if (capacity > JO_LIST_MAX_CHUNK_NODES)
+        capacity = JO_LIST_MAX_CHUNK_NODES;
+    chunk = (jo_list_node_chunk *)jo_malloc_with_behaviour(sizeof(*chunk) + capacity * sizeof(jo_node), list->allocation_behaviour);
+    if (chunk == JO_NULL)
+        return (JO_NULL);
+    chunk->capacity = (unsigned short)capacity;
+    JO_ZERO(chunk->used);
+    chunk->free_nodes = JO_NULL;
+    /* Threaded in address order so that appended nodes are contiguous */
+    nodes = __jo_list_chunk_nodes(chunk);
+    for (i = capacity - 1; i >= 0; --i)
+    {
+        nodes[i].next = chunk->free_nodes;
+        chunk->free_nodes = &nodes[i];
+    }
+    list->chunk_capacity += capacity;
+    __jo_list_push_chunk_front(list, chunk);
+    return (chunk);
+}
+
+static jo_node          *jo_list_alloc_node(jo_list * const list)
+{
+    jo_list_node_chunk  *chunk;
+    jo_node             *node;
+
+    if (list->pool != JO_NULL)
+        return ((jo_node *)jo_pool_alloc(list->pool));
+    chunk = list->chunks;
+    if ((chunk == JO_NULL || chunk->free_nodes == JO_NULL) && (chunk = __jo_list_new_chunk(list)) == JO_NULL)
+        return (JO_NULL);
+    node = chunk->free_nodes;
+    chunk->free_nodes = node->next;
+    ++chunk->used;
+    if (chunk->free_nodes == JO_NULL && chunk->next != JO_NULL)
+    {
+        __jo_list_unlink_chunk(list, chunk);
+        __jo_list_push_chunk_back(list, chunk);
+    }
+    return (node);
+}
+
+static void             jo_list_free_node(jo_list * const list, jo_node * const node)
+{
+    jo_list_node_chunk  *chunk;
+
+    if (list->pool != JO_NULL)
+    {
+        jo_pool_free(list->pool, node);
+        return;
+    }
+    /* Newest chunks are the biggest ones and there are only a few of them since the capacity doubles each time */
+    for (chunk = list->last_chunk; chunk != JO_NULL; chunk = chunk->prev)
+        if (node >= __jo_list_chunk_nodes(chunk) && node < __jo_list_chunk_nodes(chunk) + chunk->capacity)
+            break;
+#ifdef JO_DEBUG
+    if (chunk == JO_NULL)
+    {
+        jo_core_error("Node not allocated by this list");
+        return;
+    }
+#endif
+    if (--chunk->used == 0)
+    {
+        __jo_list_unlink_chunk(list, chunk);
+        list->chunk_capacity -= chunk->capacity;
+        jo_free(chunk);
+        return;
+    }
+    if (chunk->free_nodes == JO_NULL && chunk != list->chunks)
+    {
+        __jo_list_unlink_chunk(list, chunk);
+        __jo_list_push_chunk_front(list, chunk);
+    }
+    node->next = chunk->free_nodes;
+    chunk->free_nodes = node;
+}
+
+void                    jo_list_release_chunks(jo_list * const list)
+{
+    jo_list_node_chunk  *chunk;
+
+#ifdef JO_DEBUG
+    if (list->count != 0)
+    {
+        jo_core_error("List is not empty");
+        return;
+    }
+#endif
+    /* Dead nodes still live in the chunks until the iteration ends */
+    if (list->iteration_depth)
+        return;
+    while ((chunk = list->chunks) != JO_NULL)
+    {
+        list->chunks = chunk->next;
+        jo_free(chunk);
+    }
+    list->last_chunk = JO_NULL;
+    JO_ZERO(list->chunk_capacity);
 }
 
 jo_node             *jo_list_add(jo_list * const list, const jo_list_data data)
 {
     jo_node         *node;
 
-    node = (jo_node *)jo_malloc_with_behaviour(sizeof(jo_node), list->allocation_behaviour);
+    node = jo_list_alloc_node(list);
     if (node == JO_NULL)
     {
 #ifdef JO_DEBUG
@@ -113,7 +277,52 @@ void            jo_list_remove(jo_list * const list, const jo_node * const node_
             list->last = JO_NULL;
         }
     }
-    jo_free(node_to_delete);
+    --list->count;
+    if (list->iteration_depth)
+    {
+        /* next stays readable by the iteration, which skips dead nodes (prev tagged with JO_LIST_DEAD_NODE) */
+        ((jo_node *)node_to_delete)->prev = (jo_node *)((unsigned char *)list->dead_nodes + JO_LIST_DEAD_NODE);
+        list->dead_nodes = (jo_node *)node_to_delete;
+        return;
+    }
+    jo_list_free_node(list, (jo_node *)node_to_delete);
+}
+
+void            __jo_list_free_dead_nodes(jo_list * const list)
+{
+    jo_node     *node;
+
+    while ((node = list->dead_nodes) != JO_NULL)
+    {
+        list->dead_nodes = (jo_node *)((unsigned char *)node->prev - JO_LIST_DEAD_NODE);
+        jo_list_free_node(list, node);
+    }
+}
+
+void            jo_intrusive_list_add(jo_intrusive_list * const list, jo_list_link * const link)
+{
+    link->next = JO_NULL;
+    link->prev = list->last;
+    if (list->last == JO_NULL)
+        list->first = link;
+    else
+        list->last->next = link;
+    list->last = link;
+    ++list->count;
+}
+
+void            jo_intrusive_list_remove(jo_intrusive_list * const list, jo_list_link * const link)
+{
+    if (link->prev != JO_NULL)
+        link->prev->next = link->next;
+    else
+        list->first = link->next;
+    if (link->next != JO_NULL)
+        link->next->prev = link->prev;
+    else
+        list->last = link->prev;
+    link->prev = JO_NULL;
+    link->next = JO_NULL;
     --list->count;
 }
 
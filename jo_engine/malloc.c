@@ -40,43 +40,346 @@
 #include "jo/smpc.h"
 #include "jo/core.h"
 
-#define JO_BLOCK_FREE           (~0)
+#define JO_BLOCK_USED           (0)
+#define JO_BLOCK_FREE           (1)
+#define JO_BLOCK_PREV_FREE      (2)
+
+/*
+** Free blocks are kept in size classes (bins) for each zone:
+**   - bins [0, JO_MALLOC_SMALL_BIN_COUNT[ hold exactly one block size (4 bytes step)
+**   - next bins hold power of two ranges [2^k, 2^(k+1)[
+** A bitmap tells which bins are not empty so the allocator never walks the heap.
+**
+** Boundary tags: a free block stores its size in its last 4 bytes and the following
+** block is flagged JO_BLOCK_PREV_FREE, so jo_free() can merge both neighbours in O(1).
+*/
+#define JO_MALLOC_MIN_BLOCK_SIZE    (sizeof(jo_memory_free_block) + sizeof(unsigned int))
+#define JO_MALLOC_SMALL_BIN_COUNT   (64)
+#define JO_MALLOC_SMALL_BLOCK_LIMIT (JO_MULT_BY_4(JO_MALLOC_SMALL_BIN_COUNT))
+#define JO_MALLOC_LARGE_BIN_COUNT   (24)
+#define JO_MALLOC_BIN_COUNT         (JO_MALLOC_SMALL_BIN_COUNT + JO_MALLOC_LARGE_BIN_COUNT)
+#define JO_MALLOC_BIN_BITMAP_SIZE   ((JO_MALLOC_BIN_COUNT + 31) / 32)
 
 typedef struct
 {
     short           zone;
+    unsigned short  state;
     unsigned int    size;
 }                   jo_memory_block;
 
+typedef struct __jo_memory_free_block jo_memory_free_block;
+
+struct                      __jo_memory_free_block
+{
+    jo_memory_block         header;
+    jo_memory_free_block    *prev;
+    jo_memory_free_block    *next;
+};
+
 static int __jo_memory_zone_index = 0;
 
 typedef struct
 {
-    unsigned char       *begin;
-    unsigned char       *high;
-    unsigned char       *end;
-}                       jo_memory_zone;
+    unsigned char           *begin;
+    unsigned char           *high;
+    unsigned char           *end;
+    unsigned char           *zeroed;/* memory between zeroed and end has not been cleared yet */
+    jo_memory_free_block    *bins[JO_MALLOC_BIN_COUNT];
+    unsigned int            bin_bitmap[JO_MALLOC_BIN_BITMAP_SIZE];
+    jo_memory_stats         stats;
+}                           jo_memory_zone;
 
 static jo_memory_zone   memory_zones[9/*MAIN RAM + 32MB RAM Extension*/];
+static jo_memory_stats  __jo_memory_stats;
 
-void                jo_add_memory_zone(unsigned char *ptr, const unsigned int size_in_bytes)
+static __jo_force_inline void           __jo_memory_stats_add_used(jo_memory_stats * const stats, const unsigned int size)
 {
-    register int    *tmp;
-    register int    *end;
+    stats->used_bytes += size;
+    ++stats->block_count;
+    ++stats->malloc_count;
+    if (stats->used_bytes > stats->peak_used_bytes)
+        stats->peak_used_bytes = stats->used_bytes;
+}
 
-    memory_zones[__jo_memory_zone_index].begin = ptr;
-    memory_zones[__jo_memory_zone_index].high = ptr;
-    memory_zones[__jo_memory_zone_index].end = ptr + size_in_bytes;
+static __jo_force_inline void           __jo_memory_stats_remove_used(jo_memory_stats * const stats, const unsigned int size)
+{
+    stats->used_bytes -= size;
+    --stats->block_count;
+    ++stats->free_count;
+}
+
+static __jo_force_inline unsigned int   __jo_malloc_bin_index(unsigned int size)
+{
+    register unsigned int               index;
+
+    if (size < JO_MALLOC_SMALL_BLOCK_LIMIT)
+        return JO_DIV_BY_4(size);
+    for (size /= JO_MALLOC_SMALL_BLOCK_LIMIT, index = JO_MALLOC_SMALL_BIN_COUNT; size > 1 && index < (JO_MALLOC_BIN_COUNT - 1); size >>= 1)
+        ++index;
+    return index;
+}
+
+static __jo_force_inline void           __jo_malloc_bin_push(jo_memory_zone * const zone, jo_memory_free_block * const block)
+{
+    register unsigned int               index;
+
+    index = __jo_malloc_bin_index(block->header.size);
+    block->header.state = JO_BLOCK_FREE;
+    *((unsigned int *)(((unsigned char *)block) + block->header.size) - 1) = block->header.size;
+    block->prev = JO_NULL;
+    block->next = zone->bins[index];
+    if (block->next != JO_NULL)
+        block->next->prev = block;
+    zone->bins[index] = block;
+    zone->bin_bitmap[index >> 5] |= (1 << (index & 31));
+    ++zone->stats.free_block_count;
+    ++__jo_memory_stats.free_block_count;
+}
+
+static __jo_force_inline void           __jo_malloc_bin_remove(jo_memory_zone * const zone, jo_memory_free_block * const block)
+{
+    register unsigned int               index;
+
+    if (block->prev != JO_NULL)
+        block->prev->next = block->next;
+    else
+    {
+        index = __jo_malloc_bin_index(block->header.size);
+        zone->bins[index] = block->next;
+        if (block->next == JO_NULL)
+            zone->bin_bitmap[index >> 5] &= ~(1 << (index & 31));
+    }
+    if (block->next != JO_NULL)
+        block->next->prev = block->prev;
+    block->header.state = JO_BLOCK_USED;
+    --zone->stats.free_block_count;
+    --__jo_memory_stats.free_block_count;
+}
+
+static __jo_force_inline jo_memory_block    *__jo_malloc_next_block(const jo_memory_block * const block)
+{
+    return (jo_memory_block *)(((unsigned char *)block) + block->size);
+}
+
+/** @brief Give back the end of a reused block to the bins when it is big enough
+ */
+static __jo_force_inline void           __jo_malloc_split_block(jo_memory_zone * const zone, jo_memory_block * const block, const unsigned int n)
+{
+    jo_memory_block                     *next;
+    jo_memory_free_block                *remainder;
+
+    next = __jo_malloc_next_block(block);
+    if ((block->size - n) < JO_MALLOC_MIN_BLOCK_SIZE)
+    {
+        if ((unsigned char *)next < zone->high)
+            next->state &= ~JO_BLOCK_PREV_FREE;
+        return;
+    }
+    remainder = (jo_memory_free_block *)(((unsigned char *)block) + n);
+    remainder->header.zone = block->zone;
+    remainder->header.size = block->size - n;
+    block->size = n;
+    /* The following block already has JO_BLOCK_PREV_FREE since it was merged with us on free */
+    __jo_malloc_bin_push(zone, remainder);
+}
+
+/** @brief Find the first non empty bin greater or equal than index
+ *  @return bin index or JO_MALLOC_BIN_COUNT if none
+ */
+static __jo_force_inline unsigned int   __jo_malloc_next_bin(const jo_memory_zone * const zone, unsigned int index)
+{
+    register unsigned int               word;
+    register unsigned int               bits;
+
+    word = index >> 5;
+    bits = zone->bin_bitmap[word] & (~0U << (index & 31));
+    while (bits == 0)
+    {
+        if (++word >= JO_MALLOC_BIN_BITMAP_SIZE)
+            return JO_MALLOC_BIN_COUNT;
+        bits = zone->bin_bitmap[word];
+    }
+    for (index = JO_MULT_BY_32(word); (bits & 1) == 0; bits >>= 1)
+        ++index;
+    return index;
+}
+
+static jo_memory_block                  *__jo_malloc_reuse_block(jo_memory_zone * const zone, const unsigned int n, const jo_malloc_behaviour behaviour)
+{
+    register unsigned int               index;
+    jo_memory_free_block                *block;
+
+    index = __jo_malloc_bin_index(n);
+    /* Small bins hold one block size: O(1) */
+    if (index < JO_MALLOC_SMALL_BIN_COUNT)
+    {
+        block = zone->bins[index];
+        if (block == JO_NULL && behaviour != JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE)
+        {
+            index = __jo_malloc_next_bin(zone, index);
+            block = index < JO_MALLOC_BIN_COUNT ? zone->bins[index] : JO_NULL;
+        }
+    }
+    else
+    {
+        /* Large bins hold a size range: look for a fit in this bin first */
+        for (block = zone->bins[index]; block != JO_NULL; block = block->next)
+        {
+            if (behaviour == JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE ? block->header.size == n : block->header.size >= n)
+                break;
+        }
+        if (block == JO_NULL && behaviour != JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE && (index + 1) < JO_MALLOC_BIN_COUNT)
+        {
+            index = __jo_malloc_next_bin(zone, index + 1);
+            block = index < JO_MALLOC_BIN_COUNT ? zone->bins[index] : JO_NULL;
+        }
+    }
+    if (block == JO_NULL)
+        return JO_NULL;
+#ifdef JO_DEBUG
+    if (block->header.size == 0 || (block->header.size % 4) != 0)
+    {
+        jo_core_error("Memory corrupt: Block size is null");
+        return JO_NULL;
+    }
+#endif
+    __jo_malloc_bin_remove(zone, block);
+    __jo_malloc_split_block(zone, &block->header, n);
+    return &block->header;
+}
+
+/*
+** ZERO FILL
+**
+** Zones are not cleared by jo_add_memory_zone() anymore (it was the slowest part of the boot with a RAM cartridge).
+** Memory is cleared in small slices while jo_core_run() waits for the VBLANK, and synchronously
+** when a new block is taken above the cleared area, so fresh memory is still zero-filled.
+** Define JO_MALLOC_ZERO_FILL_AT_STARTUP to restore the previous behaviour.
+*/
+
+static int              __jo_memory_zero_fill_zone = 0;
+
+#ifdef JO_MALLOC_DMA_ZERO_FILL
+
+# define JO_SH2_DMA_SAR1        (*(volatile unsigned int *)0xFFFFFF90)
+# define JO_SH2_DMA_DAR1        (*(volatile unsigned int *)0xFFFFFF94)
+# define JO_SH2_DMA_TCR1        (*(volatile unsigned int *)0xFFFFFF98)
+# define JO_SH2_DMA_CHCR1       (*(volatile unsigned int *)0xFFFFFF9C)
+# define JO_SH2_DMA_DRCR1       (*(volatile unsigned char *)0xFFFFFE72)
+# define JO_SH2_DMA_DMAOR       (*(volatile unsigned int *)0xFFFFFFB0)
+/* Destination incremented, source fixed, long word, auto request, cycle steal, enabled */
+# define JO_SH2_DMA_ZERO_FILL   (0x4A01)
+# define JO_SH2_DMA_TE          (0x2)
+
+static const unsigned int       __jo_dma_zero = 0;
+static jo_memory_zone           *__jo_dma_zero_fill_zone = JO_NULL;
+static unsigned char            *__jo_dma_zero_fill_end;
+
+static void                     __jo_memory_dma_zero_fill_wait(void)
+{
+    if (__jo_dma_zero_fill_zone == JO_NULL)
+        return;
+    while ((JO_SH2_DMA_CHCR1 & JO_SH2_DMA_TE) == 0)
+        ;
+    JO_SH2_DMA_CHCR1 = 0;
+    __jo_dma_zero_fill_zone->zeroed = __jo_dma_zero_fill_end;
+    __jo_dma_zero_fill_zone = JO_NULL;
+}
+
+static void                     __jo_memory_dma_zero_fill_start(jo_memory_zone * const zone)
+{
+    __jo_dma_zero_fill_zone = zone;
+    __jo_dma_zero_fill_end = zone->end;
+    JO_SH2_DMA_CHCR1 = 0;
+    JO_SH2_DMA_SAR1 = (unsigned int)&__jo_dma_zero;
+    JO_SH2_DMA_DAR1 = (unsigned int)zone->zeroed;
+    JO_SH2_DMA_TCR1 = JO_DIV_BY_4(zone->end - zone->zeroed);
+    JO_SH2_DMA_DRCR1 = 0;
+    JO_SH2_DMA_DMAOR |= 1;
+    JO_SH2_DMA_CHCR1 = JO_SH2_DMA_ZERO_FILL;
+}
 
+#endif
+
+static void                     __jo_memory_zero_fill(jo_memory_zone * const zone, unsigned char * const limit)
+{
+    register int                *tmp;
+    register int                *end;
+
+#ifdef JO_MALLOC_DMA_ZERO_FILL
+    if (__jo_dma_zero_fill_zone == zone)
+    {
+        __jo_memory_dma_zero_fill_wait();
+        if (zone->zeroed >= limit)
+            return;
+    }
+#endif
     // Clear memory 4 bytes at the same time
-    end = (int *)memory_zones[__jo_memory_zone_index].end;
-    for (tmp = (int *)ptr; tmp < end; ++tmp)
+    end = (int *)limit;
+    for (tmp = (int *)zone->zeroed; tmp < end; ++tmp)
         JO_ZERO(*tmp);
+    zone->zeroed = limit;
+}
+
+bool                            jo_memory_zero_fill_step(unsigned int max_bytes)
+{
+    jo_memory_zone              *zone;
+
+    for (; __jo_memory_zero_fill_zone < __jo_memory_zone_index; ++__jo_memory_zero_fill_zone)
+    {
+        zone = &memory_zones[__jo_memory_zero_fill_zone];
+#ifdef JO_MALLOC_DMA_ZERO_FILL
+        JO_UNUSED_ARG(max_bytes);
+        if (__jo_dma_zero_fill_zone != JO_NULL)
+        {
+            if ((JO_SH2_DMA_CHCR1 & JO_SH2_DMA_TE) == 0)
+                return (true);
+            __jo_memory_dma_zero_fill_wait();
+        }
+        if (zone->zeroed < zone->end)
+        {
+            __jo_memory_dma_zero_fill_start(zone);
+            return (true);
+        }
+#else
+        if (zone->zeroed < zone->end)
+        {
+            __jo_memory_zero_fill(zone, (unsigned int)(zone->end - zone->zeroed) > max_bytes ? zone->zeroed + max_bytes : zone->end);
+            return (true);
+        }
+#endif
+    }
+    return (false);
+}
+
+unsigned int                    jo_memory_zero_fill_pending_bytes(void)
+{
+    register int                zone;
+    unsigned int                pending;
+
+    JO_ZERO(pending);
+    for (zone = __jo_memory_zero_fill_zone; zone < __jo_memory_zone_index; ++zone)
+        pending += memory_zones[zone].end - memory_zones[zone].zeroed;
+    return (pending);
+}
+
+void                jo_add_memory_zone(unsigned char *ptr, const unsigned int size_in_bytes, const bool is_zeroed)
+{
+    memory_zones[__jo_memory_zone_index].begin = ptr;
+    memory_zones[__jo_memory_zone_index].high = ptr;
+    memory_zones[__jo_memory_zone_index].end = ptr + size_in_bytes;
+    memory_zones[__jo_memory_zone_index].zeroed = is_zeroed ? ptr + size_in_bytes : ptr;
+    memory_zones[__jo_memory_zone_index].stats.total_bytes = size_in_bytes;
+    __jo_memory_stats.total_bytes += size_in_bytes;
+#ifdef JO_MALLOC_ZERO_FILL_AT_STARTUP
+    __jo_memory_zero_fill(&memory_zones[__jo_memory_zone_index], memory_zones[__jo_memory_zone_index].end);
+#endif
     ++__jo_memory_zone_index;
 }
 
-void	                *jo_malloc_with_behaviour(unsigned int n, const jo_malloc_behaviour behaviour)
+void	                *jo_malloc_with_placement(unsigned int n, const jo_malloc_behaviour behaviour, const jo_malloc_zone_placement placement)
 {
+    register int        i;
     register int        zone;
     jo_memory_block     *block;
 
@@ -90,61 +393,44 @@ void	                *jo_malloc_with_behaviour(unsigned int n, const jo_malloc_b
     n += sizeof(*block);
     while (n % 4)
         ++n;
-    for (JO_ZERO(zone); zone < __jo_memory_zone_index; ++zone)
+    if (n < JO_MALLOC_MIN_BLOCK_SIZE)
+        n = JO_MALLOC_MIN_BLOCK_SIZE;
+    for (JO_ZERO(i); i < __jo_memory_zone_index; ++i)
     {
-        if (behaviour == JO_FAST_ALLOCATION)
-        {
-malloc_new_segment:
-            block = (jo_memory_block *)memory_zones[zone].high;
-            if (((unsigned char *)block + n) <= memory_zones[zone].end)
-            {
-                memory_zones[zone].high += n;
-                goto malloc_new_block;
-            }
-            if (behaviour == JO_MALLOC_TRY_REUSE_BLOCK)
-                continue;
-        }
-        block = (jo_memory_block *)memory_zones[zone].begin;
-        while (((unsigned char *)block + n) <= memory_zones[zone].high)
+        /* Zone 0 is the Main RAM, next zones are the RAM cartridge banks */
+        if (placement == JO_ZONE_PREFER_BULK)
+            zone = (i + 1) < __jo_memory_zone_index ? i + 1 : 0;
+        else
+            zone = i;
+        if (behaviour != JO_FAST_ALLOCATION && (block = __jo_malloc_reuse_block(&memory_zones[zone], n, behaviour)) != JO_NULL)
+            goto malloc_new_block;
+        block = (jo_memory_block *)memory_zones[zone].high;
+        if (((unsigned char *)block + n) <= memory_zones[zone].end)
         {
-            if (block->zone == JO_BLOCK_FREE)
-            {
-#ifdef JO_DEBUG
-                if (block->size == 0 || (block->size % 4) != 0)
-                {
-                    jo_core_error("Memory corrupt: Block size is null");
-                    goto malloc_new_block;
-                }
-#endif
-                if (behaviour == JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE)
-                {
-                    if (block->size == n)
-                    {
-                        block->zone = zone;
-                        return (block + 1);
-                    }
-                }
-                else if (block->size >= n)
-                {
-                    block->zone = zone;
-                    return (block + 1);
-                }
-            }
-            block = (jo_memory_block *)(((unsigned char *)block) + block->size);
+            memory_zones[zone].high += n;
+            if (memory_zones[zone].high > memory_zones[zone].zeroed)
+                __jo_memory_zero_fill(&memory_zones[zone], memory_zones[zone].high);
+            block->zone = zone;
+            block->state = JO_BLOCK_USED;
+            block->size = n;
+            goto malloc_new_block;
         }
-        if (behaviour != JO_FAST_ALLOCATION)
-            goto malloc_new_segment;
+        /* Coalesced free blocks never match an exact size again: split one instead of failing */
+        if (behaviour != JO_MALLOC_TRY_REUSE_BLOCK && (block = __jo_malloc_reuse_block(&memory_zones[zone], n, JO_MALLOC_TRY_REUSE_BLOCK)) != JO_NULL)
+            goto malloc_new_block;
     }
     return JO_NULL;
 malloc_new_block:
-    block->zone = zone;
-    block->size = n;
+    __jo_memory_stats_add_used(&memory_zones[zone].stats, block->size);
+    __jo_memory_stats_add_used(&__jo_memory_stats, block->size);
     return (block + 1);
 }
 
 inline void                    jo_free(const void * const p)
 {
     jo_memory_block             *block;
+    jo_memory_block             *neighbour;
+    jo_memory_zone              *zone;
 
 #ifdef JO_DEBUG
     if (p == JO_NULL)
@@ -155,81 +441,89 @@ inline void                    jo_free(const void * const p)
 #endif
     block = ((jo_memory_block *)p) - 1;
 #ifdef JO_DEBUG
-    if (block->size == 0 || (block->size % 4) != 0)
+    if (block->size == 0 || (block->size % 4) != 0 || (block->state & JO_BLOCK_FREE))
     {
         jo_core_error("Bad pointer: %x", (unsigned int)p);
         return ;
     }
 #endif
-    if ((((unsigned char *)block) + block->size) == memory_zones[block->zone].high)
-        memory_zones[block->zone].high = (unsigned char *)block;
+    zone = &memory_zones[block->zone];
+    __jo_memory_stats_remove_used(&zone->stats, block->size);
+    __jo_memory_stats_remove_used(&__jo_memory_stats, block->size);
+    neighbour = __jo_malloc_next_block(block);
+    if ((unsigned char *)neighbour < zone->high && (neighbour->state & JO_BLOCK_FREE))
+    {
+        __jo_malloc_bin_remove(zone, (jo_memory_free_block *)neighbour);
+        block->size += neighbour->size;
+    }
+    if (block->state & JO_BLOCK_PREV_FREE)
+    {
+        neighbour = (jo_memory_block *)(((unsigned char *)block) - *(((unsigned int *)block) - 1));
+        __jo_malloc_bin_remove(zone, (jo_memory_free_block *)neighbour);
+        neighbour->size += block->size;
+        block = neighbour;
+    }
+    neighbour = __jo_malloc_next_block(block);
+    if ((unsigned char *)neighbour == zone->high)
+        zone->high = (unsigned char *)block;
     else
-        block->zone = JO_BLOCK_FREE;
+    {
+        __jo_malloc_bin_push(zone, (jo_memory_free_block *)block);
+        neighbour->state |= JO_BLOCK_PREV_FREE;
+    }
 }
 
-#ifdef JO_DEBUG
+void                    *jo_calloc_with_behaviour(const unsigned int n, const jo_malloc_behaviour behaviour)
+{
+    void                *ptr;
 
-int                     jo_memory_usage_percent(void)
+    ptr = jo_malloc_with_behaviour(n, behaviour);
+    if (ptr != JO_NULL)
+        jo_memset(ptr, 0, n);
+    return (ptr);
+}
+
+int                     jo_memory_zone_count(void)
 {
-    register int        zone;
-    unsigned int        mem_total;
-    unsigned int        mem_free;
-    jo_memory_block     *block;
+    return (__jo_memory_zone_index);
+}
 
-    JO_ZERO(mem_total);
-    JO_ZERO(mem_free);
-    for (JO_ZERO(zone); zone < __jo_memory_zone_index; ++zone)
-    {
-        mem_total += memory_zones[zone].end - memory_zones[zone].begin;
-        if (memory_zones[zone].high < memory_zones[zone].end)
-            mem_free += memory_zones[zone].end - memory_zones[zone].high;
-        block = (jo_memory_block *)memory_zones[zone].begin;
-        while ((unsigned char *)block < memory_zones[zone].high)
-        {
-            if (block->zone == JO_BLOCK_FREE)
-            {
+const jo_memory_stats   *jo_memory_get_zone_stats(const int zone)
+{
 #ifdef JO_DEBUG
-                if (block->size == 0 || (block->size % 4) != 0)
-                {
-                    jo_core_error("Memory corrupt: Block size is null");
-                    break;
-                }
-#endif
-                mem_free += block->size;
-            }
-            block = (jo_memory_block *)(((unsigned char *)block) + block->size);
-        }
+    if (zone < 0 || zone >= __jo_memory_zone_index)
+    {
+        jo_core_error("Invalid zone (%d)", zone);
+        return (JO_NULL);
     }
-    return (JO_PERCENT_USED(mem_total, mem_free));
+#endif
+    return (&memory_zones[zone].stats);
 }
 
-int                     jo_memory_fragmentation(void)
+const jo_memory_stats   *jo_memory_get_stats(void)
 {
-    register int        zone;
-    unsigned int        fragment;
-    jo_memory_block     *block;
+    return (&__jo_memory_stats);
+}
 
-    JO_ZERO(fragment);
-    for (JO_ZERO(zone); zone < __jo_memory_zone_index; ++zone)
-    {
-        block = (jo_memory_block *)memory_zones[zone].begin;
-        while ((unsigned char *)block < memory_zones[zone].high)
-        {
-#ifdef JO_DEBUG
-            if (block->size == 0 || (block->size % 4) != 0)
-            {
-                jo_core_error("Memory corrupt: Block size is null");
-                break;
-            }
-#endif
-            block = (jo_memory_block *)(((unsigned char *)block) + block->size);
-            ++fragment;
-        }
-    }
-    return fragment;
+int                     jo_memory_usage_percent(void)
+{
+    if (__jo_memory_stats.total_bytes == 0)
+        return (0);
+    return (JO_PERCENT_USED(__jo_memory_stats.total_bytes, __jo_memory_stats.total_bytes - __jo_memory_stats.used_bytes));
 }
 
-#endif
+int                     jo_memory_fragmentation(void)
+{
+    return (__jo_memory_stats.free_block_count);
+}
+
+void                    jo_memory_print_stats(const int x, const int y)
+{
+    jo_printf(x, y, "Heap: %d%% (%dKB)  ", jo_memory_usage_percent(), __jo_memory_stats.used_bytes >> 10);
+    jo_printf(x, y + 1, "Peak: %d%% (%dKB)  ", JO_PERCENT_USED(__jo_memory_stats.total_bytes, __jo_memory_stats.total_bytes - __jo_memory_stats.peak_used_bytes),
+              __jo_memory_stats.peak_used_bytes >> 10);
+    jo_printf(x, y + 2, "Blocks: %d Free: %d  ", __jo_memory_stats.block_count, __jo_memory_stats.free_block_count);
+}
 
 /*
 ** END OF FILE
@@ -37,15 +37,17 @@
 #include "jo/smpc.h"
 #include "jo/core.h"
 #include "jo/colors.h"
-#include "jo/sprites.h"
 #include "jo/tools.h"
+#include "jo/sprites.h"
 #include "jo/malloc.h"
 #include "jo/background.h"
 #include "jo/math.h"
 #include "jo/fs.h"
+#include "jo/collision.h"
 #include "jo/hitbox.h"
 #include "jo/map.h"
 #include "jo/sprite_animator.h"
+#include "jo/pool.h"
 #include "jo/list.h"
 #include "jo/3d.h"
 
@@ -876,6 +876,17 @@ int                             jo_random(int max)
     return __jo_seed % max + 1;
 }
 
+void                            jo_random_set_seed(int seed)
+{
+    seed %= JO_RANDOM_M;
+    __jo_seed = seed <= 0 ? seed + JO_RANDOM_M - 1 : seed;
+}
+
+int                             jo_random_get_seed(void)
+{
+    return (__jo_seed);
+}
+
 void                jo_planar_rotate(const jo_pos2D * const point, const jo_pos2D * const origin, const int angle, jo_pos2D * const result)
 {
     register int    dx;
@@ -0,0 +1,106 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** INCLUDES
+*/
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/pool.h"
+
+bool                jo_pool_init(jo_pool * const pool, unsigned int item_size, const unsigned int capacity)
+{
+#ifdef JO_DEBUG
+    if (item_size == 0 || capacity == 0)
+    {
+        jo_core_error("item_size and capacity must be greater than zero");
+        return (false);
+    }
+#endif
+    /* Free items store the next free item in their first bytes */
+    if (item_size < sizeof(void *))
+        item_size = sizeof(void *);
+    while (item_size % 4)
+        ++item_size;
+    pool->item_size = item_size;
+    pool->capacity = capacity;
+    pool->storage = (unsigned char *)jo_malloc_with_behaviour(item_size * capacity, JO_MALLOC_TRY_REUSE_BLOCK);
+    if (pool->storage == JO_NULL)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Out of memory");
+#endif
+        pool->free_list = JO_NULL;
+        JO_ZERO(pool->capacity);
+        JO_ZERO(pool->count);
+        return (false);
+    }
+    jo_pool_reset(pool);
+    return (true);
+}
+
+void                jo_pool_reset(jo_pool * const pool)
+{
+    register unsigned char  *item;
+    register unsigned char  *next;
+    unsigned char           *end;
+
+    JO_ZERO(pool->count);
+    if (pool->storage == JO_NULL)
+        return;
+    end = pool->storage + pool->item_size * (pool->capacity - 1);
+    for (item = pool->storage; item < end; item = next)
+    {
+        next = item + pool->item_size;
+        *((void **)item) = next;
+    }
+    *((void **)end) = JO_NULL;
+    pool->free_list = pool->storage;
+}
+
+void                jo_pool_destroy(jo_pool * const pool)
+{
+    if (pool->storage != JO_NULL)
+        jo_free(pool->storage);
+    pool->storage = JO_NULL;
+    pool->free_list = JO_NULL;
+    JO_ZERO(pool->capacity);
+    JO_ZERO(pool->count);
+}
+
+/*
+** END OF FILE
+*/
@@ -0,0 +1,326 @@
+/*
+** Jo Sega Saturn Engine
+** Copyright (c) 2012-2017, Johannes Fetz (johannesfetz@gmail.com)
+** All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions are met:
+**     * Redistributions of source code must retain the above copyright
+**       notice, this list of conditions and the following disclaimer.
+**     * Redistributions in binary form must reproduce the above copyright
+**       notice, this list of conditions and the following disclaimer in the
+**       documentation and/or other materials provided with the distribution.
+**     * Neither the name of the Johannes Fetz nor the
+**       names of its contributors may be used to endorse or promote products
+**       derived from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+** ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+** WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+** DISCLAIMED. IN NO EVENT SHALL Johannes Fetz BE LIABLE FOR ANY
+** DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+** (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+** LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+** ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+** SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/*
+** INCLUDES
+*/
+#include <stdbool.h>
+#include "jo/sgl_prototypes.h"
+#include "jo/conf.h"
+#include "jo/types.h"
+#include "jo/sega_saturn.h"
+#include "jo/smpc.h"
+#include "jo/core.h"
+#include "jo/tools.h"
+#include "jo/malloc.h"
+#include "jo/math.h"
+#include "jo/input.h"
+#include "jo/backup.h"
+#include "jo/replay.h"
+
+/*
+** INTERNAL MACROS
+*/
+# define JO_REPLAY_MAGIC        (0x4A4F5250) /* JORP */
+# define JO_REPLAY_MAX_RUN      (0xFFFF)
+
+/*
+** GLOBALS
+*/
+jo_replay                       *__jo_replay = JO_NULL;
+
+/*
+** STREAM (BIG ENDIAN)
+*/
+
+static  __jo_force_inline void          __jo_replay_write_short(unsigned char * const ptr, const unsigned int value)
+{
+    ptr[0] = (unsigned char)(value >> 8);
+    ptr[1] = (unsigned char)value;
+}
+
+static  __jo_force_inline unsigned int  __jo_replay_read_short(const unsigned char * const ptr)
+{
+    return ((ptr[0] << 8) | ptr[1]);
+}
+
+static  __jo_force_inline void          __jo_replay_write_int(unsigned char * const ptr, const unsigned int value)
+{
+    __jo_replay_write_short(ptr, value >> 16);
+    __jo_replay_write_short(ptr + 2, value);
+}
+
+static  __jo_force_inline unsigned int  __jo_replay_read_int(const unsigned char * const ptr)
+{
+    return ((__jo_replay_read_short(ptr) << 16) | __jo_replay_read_short(ptr + 2));
+}
+
+/*
+** GAMEPADS
+*/
+
+/* Pressed keys (1 = pressed) */
+static  __jo_force_inline unsigned short    __jo_replay_get_pressed(const int port)
+{
+#if JO_COMPILE_USING_SGL
+    return ((unsigned short)~Smpc_Peripheral[port].data);
+#else
+    return (jo_inputs[port].pressed);
+#endif
+}
+
+static  __jo_force_inline void          __jo_replay_set_pressed(const int port, const unsigned short pressed, const unsigned short previous)
+{
+#if JO_COMPILE_USING_SGL
+    Smpc_Peripheral[port].data = (unsigned short)~pressed;
+    Smpc_Peripheral[port].push = (unsigned short)~(pressed & ~previous);
+#else
+    jo_inputs[port].pressed = pressed;
+    jo_inputs[port].on_keydown = pressed & ~previous;
+    jo_inputs[port].on_keyup = previous & ~pressed;
+#endif
+}
+
+/*
+** RECORDING
+*/
+
+bool                            jo_replay_start_recording(jo_replay * const replay, const unsigned int max_runs)
+{
+#ifdef JO_DEBUG
+    if (max_runs == 0)
+    {
+        jo_core_error("Invalid run count");
+        return (false);
+    }
+#endif
+    jo_replay_stop(replay);
+    jo_replay_free(replay);
+    replay->capacity = JO_REPLAY_HEADER_SIZE + max_runs * JO_REPLAY_RUN_SIZE;
+    if ((replay->stream = (unsigned char *)jo_malloc_with_behaviour(replay->capacity, JO_MALLOC_TRY_REUSE_BLOCK)) == JO_NULL)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Out of memory");
+#endif
+        JO_ZERO(replay->capacity);
+        return (false);
+    }
+    replay->length = JO_REPLAY_HEADER_SIZE;
+    JO_ZERO(replay->frame);
+    JO_ZERO(replay->frame_count);
+    __jo_replay_write_int(replay->stream, JO_REPLAY_MAGIC);
+    __jo_replay_write_int(replay->stream + 4, (unsigned int)jo_random_get_seed());
+    __jo_replay_write_int(replay->stream + 8, 0);
+    __jo_replay_write_int(replay->stream + 12, 0);
+    replay->state = JoReplayRecording;
+    __jo_replay = replay;
+    return (true);
+}
+
+static void                     __jo_replay_record_frame(jo_replay * const replay)
+{
+    unsigned char               *run;
+    unsigned short              pressed1;
+    unsigned short              pressed2;
+
+    pressed1 = __jo_replay_get_pressed(0);
+    pressed2 = __jo_replay_get_pressed(1);
+    run = replay->stream + replay->length - JO_REPLAY_RUN_SIZE;
+    if (replay->length > JO_REPLAY_HEADER_SIZE && __jo_replay_read_short(run) < JO_REPLAY_MAX_RUN &&
+        __jo_replay_read_short(run + 2) == pressed1 && __jo_replay_read_short(run + 4) == pressed2)
+        __jo_replay_write_short(run, __jo_replay_read_short(run) + 1);
+    else
+    {
+        if (replay->length + JO_REPLAY_RUN_SIZE > replay->capacity)
+        {
+#ifdef JO_DEBUG
+            jo_core_error("Replay is full");
+#endif
+            jo_replay_stop(replay);
+            return;
+        }
+        run += JO_REPLAY_RUN_SIZE;
+        __jo_replay_write_short(run, 1);
+        __jo_replay_write_short(run + 2, pressed1);
+        __jo_replay_write_short(run + 4, pressed2);
+        replay->length += JO_REPLAY_RUN_SIZE;
+    }
+    ++replay->frame;
+}
+
+/*
+** PLAYBACK
+*/
+
+static bool                     __jo_replay_is_valid_stream(const unsigned char * const stream, const unsigned int length)
+{
+    unsigned int                runs;
+    unsigned int                i;
+
+    if (stream == JO_NULL || length < JO_REPLAY_HEADER_SIZE || __jo_replay_read_int(stream) != JO_REPLAY_MAGIC)
+        return (false);
+    /* Compared to the run count that fits in the stream so that a huge run count can't overflow */
+    runs = __jo_replay_read_int(stream + 12);
+    if (runs > (length - JO_REPLAY_HEADER_SIZE) / JO_REPLAY_RUN_SIZE)
+        return (false);
+    /* A run of 0 frame would make run_left wrap during the playback */
+    for (JO_ZERO(i); i < runs; ++i)
+        if (__jo_replay_read_short(stream + JO_REPLAY_HEADER_SIZE + i * JO_REPLAY_RUN_SIZE) == 0)
+            return (false);
+    return (true);
+}
+
+bool                            jo_replay_start_playing(jo_replay * const replay, unsigned char * const stream, const unsigned int length)
+{
+    if (!__jo_replay_is_valid_stream(stream, length))
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Invalid replay stream");
+#endif
+        return (false);
+    }
+    jo_replay_stop(replay);
+    if (replay->stream != stream)
+    {
+        jo_replay_free(replay);
+        replay->stream = stream;
+    }
+    replay->length = JO_REPLAY_HEADER_SIZE + __jo_replay_read_int(stream + 12) * JO_REPLAY_RUN_SIZE;
+    replay->frame_count = __jo_replay_read_int(stream + 8);
+    replay->cursor = JO_REPLAY_HEADER_SIZE;
+    JO_ZERO(replay->run_left);
+    JO_ZERO(replay->frame);
+    JO_ZERO(replay->previous[0]);
+    JO_ZERO(replay->previous[1]);
+    jo_random_set_seed((int)__jo_replay_read_int(stream + 4));
+    replay->state = JoReplayPlaying;
+    __jo_replay = replay;
+    return (true);
+}
+
+static void                     __jo_replay_play_frame(jo_replay * const replay)
+{
+    unsigned short              pressed1;
+    unsigned short              pressed2;
+
+    if (replay->run_left == 0)
+    {
+        if (replay->cursor >= replay->length)
+        {
+            jo_replay_stop(replay);
+            return;
+        }
+        replay->run_left = __jo_replay_read_short(replay->stream + replay->cursor);
+        replay->cursor += JO_REPLAY_RUN_SIZE;
+    }
+    pressed1 = __jo_replay_read_short(replay->stream + replay->cursor - 4);
+    pressed2 = __jo_replay_read_short(replay->stream + replay->cursor - 2);
+    __jo_replay_set_pressed(0, pressed1, replay->previous[0]);
+    __jo_replay_set_pressed(1, pressed2, replay->previous[1]);
+    replay->previous[0] = pressed1;
+    replay->previous[1] = pressed2;
+    --replay->run_left;
+    ++replay->frame;
+}
+
+/*
+** COMMON
+*/
+
+void                            jo_replay_update(void)
+{
+    if (__jo_replay == JO_NULL)
+        return;
+    if (__jo_replay->state == JoReplayRecording)
+        __jo_replay_record_frame(__jo_replay);
+    else if (__jo_replay->state == JoReplayPlaying)
+        __jo_replay_play_frame(__jo_replay);
+}
+
+void                            jo_replay_stop(jo_replay * const replay)
+{
+    if (replay->state == JoReplayRecording)
+    {
+        replay->frame_count = replay->frame;
+        __jo_replay_write_int(replay->stream + 8, replay->frame_count);
+        __jo_replay_write_int(replay->stream + 12, (replay->length - JO_REPLAY_HEADER_SIZE) / JO_REPLAY_RUN_SIZE);
+    }
+    replay->state = JoReplayStopped;
+    if (__jo_replay == replay)
+        __jo_replay = JO_NULL;
+}
+
+void                            jo_replay_free(jo_replay * const replay)
+{
+    jo_replay_stop(replay);
+    if (replay->capacity > 0)
+        jo_free(replay->stream);
+    replay->stream = JO_NULL;
+    JO_ZERO(replay->capacity);
+    JO_ZERO(replay->length);
+}
+
+#ifdef JO_COMPILE_WITH_BACKUP_SUPPORT
+
+bool                            jo_replay_save_to_backup(jo_replay * const replay, const jo_backup_device backup_device, const char * const fname)
+{
+    if (replay->state == JoReplayRecording)
+        jo_replay_stop(replay);
+    if (replay->stream == JO_NULL || replay->length > 0xFFFF)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Replay can't be saved");
+#endif
+        return (false);
+    }
+    return (jo_backup_save_file_contents(backup_device, fname, "Replay", replay->stream, (unsigned short)replay->length));
+}
+
+bool                            jo_replay_play_from_backup(jo_replay * const replay, const jo_backup_device backup_device, const char * const fname)
+{
+    unsigned char               *stream;
+    unsigned int                length;
+
+    if ((stream = (unsigned char *)jo_backup_load_file_contents(backup_device, fname, &length)) == JO_NULL)
+        return (false);
+    jo_replay_free(replay);
+    if (!jo_replay_start_playing(replay, stream, length))
+    {
+        jo_free(stream);
+        return (false);
+    }
+    /* The stream belongs to the replay now */
+    replay->capacity = length;
+    return (true);
+}
+
+#endif /* !JO_COMPILE_WITH_BACKUP_SUPPORT */
+
+/*
+** END OF FILE
+*/
@@ -44,8 +44,11 @@
 #include "jo/image.h"
 #include "jo/sprites.h"
 #include "jo/math.h"
+#include "jo/pool.h"
 #include "jo/list.h"
 #include "jo/3d.h"
+#include "jo/collision.h"
+#include "jo/hitbox.h"
 
 /*
 ** MACROS
@@ -61,11 +64,31 @@ jo_sprite_attributes    __jo_sprite_attributes = {0, 0, 0, 0, JO_FIXED_1};
 jo_pos3D                __jo_sprite_pos = {0, 0, 120};
 jo_texture_definition   __jo_sprite_def[JO_MAX_SPRITE];
 jo_picture_definition   __jo_sprite_pic[JO_MAX_SPRITE];
+jo_sprite_hitbox        __jo_sprite_hitbox[JO_MAX_SPRITE];
 int                     __jo_gouraud_shading_runtime_index = -1;
 int				        __jo_hash_table[JO_MAX_SPRITE];
+unsigned int            *__jo_sprite_mask[JO_MAX_SPRITE];
+bool                    __jo_sprite_build_collision_masks = false;
 static int				__jo_sprite_addr = 0;
 static int				__jo_sprite_id = -1;
 
+/** @brief Sprite displayed every frame until released (see jo_sprite_retain()) */
+typedef struct
+{
+    short                   sprite_id;
+    short                   x;
+    short                   y;
+    short                   z;
+    unsigned short          direction;
+#if JO_COMPILE_USING_SGL
+    bool                    visible;
+    jo_sprite_attributes    attributes;
+#endif
+}                           jo_retained_sprite;
+
+/* Indexed by retained instance (the VDP1 retained command slot without SGL), sprite_id is -1 when free */
+static jo_retained_sprite   __jo_retained_sprites[JO_MAX_RETAINED_SPRITES];
+
 static  __jo_force_inline unsigned int	__jo_get_next_sprite_address(const unsigned int sprite_address, const unsigned int sprite_width,
         const unsigned int sprite_height, const unsigned int sprite_color_mode)
 {
@@ -98,7 +121,57 @@ void                    jo_sprite_init(void)
 
     __jo_sprite_id = -1;
     for (JO_ZERO(i); i < JO_MAX_SPRITE; ++i)
+    {
         JO_ZERO(__jo_hash_table[i]);
+        __jo_sprite_mask[i] = JO_NULL;
+        __jo_sprite_hitbox[i].boxes = JO_NULL;
+    }
+    for (JO_ZERO(i); i < JO_MAX_RETAINED_SPRITES; ++i)
+        __jo_retained_sprites[i].sprite_id = -1;
+}
+
+static void                 __jo_sprite_free_collision_mask(const int sprite_id)
+{
+    if (__jo_sprite_mask[sprite_id] == JO_NULL)
+        return;
+    jo_free(__jo_sprite_mask[sprite_id]);
+    __jo_sprite_mask[sprite_id] = JO_NULL;
+}
+
+/* Built from work RAM image data before it is copied in VRAM */
+static void                 __jo_sprite_build_collision_mask(const int sprite_id, const void * const data, const unsigned short width, const unsigned short height, const unsigned short cmode)
+{
+    register unsigned int   *mask;
+    register int            x;
+    register int            y;
+    int                     words_per_row;
+    bool                    opaque;
+
+    __jo_sprite_free_collision_mask(sprite_id);
+    words_per_row = JO_DIV_BY_32(width + 31);
+    mask = (unsigned int *)jo_malloc_with_behaviour(JO_MULT_BY_4(words_per_row * height), JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE);
+    if (mask == JO_NULL)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Out of memory");
+#endif
+        return;
+    }
+    __jo_sprite_mask[sprite_id] = mask;
+    for (JO_ZERO(y); y < height; ++y, mask += words_per_row)
+    {
+        for (JO_ZERO(x); x < words_per_row; ++x)
+            JO_ZERO(mask[x]);
+        for (JO_ZERO(x); x < width; ++x)
+        {
+            if (cmode == COL_256)
+                opaque = ((const unsigned char *)data)[x + y * width] != 0;
+            else
+                opaque = !jo_sprite_is_pixel_transparent((const jo_color *)data, x, y, width);
+            if (opaque)
+                mask[JO_DIV_BY_32(x)] |= 0x80000000 >> (x & 31);
+        }
+    }
 }
 
 int				jo_sprite_name2id(const char * const restrict filename)
@@ -149,6 +222,8 @@ int				            jo_sprite_replace(const jo_img * const img, const int sprite_
         return (sprite_id);
     }
 #endif
+    if (__jo_sprite_mask[sprite_id] != JO_NULL)
+        __jo_sprite_build_collision_mask(sprite_id, img->data, img->width, img->height, picture->color_mode);
     picture->data = img->data;
     jo_dma_copy(picture->data, (void *)(JO_VDP1_VRAM + JO_MULT_BY_8(texture->adr)),
                 (unsigned int)((JO_MULT_BY_4(texture->width * texture->height)) >> (picture->color_mode)));
@@ -201,6 +276,10 @@ static int                  __internal_jo_sprite_add(void * const data, const un
     picture->index = __jo_sprite_id;
     picture->data = data;
 
+    jo_hitbox_reset(__jo_sprite_id);
+    if (__jo_sprite_build_collision_masks)
+        __jo_sprite_build_collision_mask(__jo_sprite_id, data, width, height, cmode);
+
     jo_dma_copy(data,
                 (void *)(JO_VDP1_VRAM + JO_MULT_BY_8(texture->adr)),
                 (unsigned int)((JO_MULT_BY_4(texture->width * texture->height)) >> (cmode)));
@@ -235,13 +314,16 @@ int				            jo_sprite_add_8bits_image(const jo_img_8bits * const img)
 void                        jo_sprite_free_from(const int sprite_id)
 {
     jo_texture_definition   *texture;
+    register int            i;
 
     texture = &__jo_sprite_def[sprite_id];
-#ifdef JO_COMPILE_WITH_3D_SUPPORT
-    register int    i;
-#endif // JO_COMPILE_WITH_3D_SUPPORT
     if (sprite_id > __jo_sprite_id)
         return ;
+    for (i = sprite_id; i <= __jo_sprite_id; ++i)
+    {
+        __jo_sprite_free_collision_mask(i);
+        jo_hitbox_reset(i);
+    }
 #ifdef JO_COMPILE_WITH_3D_SUPPORT
     for (i = sprite_id; i < __jo_sprite_id; ++i)
     {
@@ -301,10 +383,10 @@ static  __jo_force_inline void __jo_set_sprite_attributes(SPR_ATTR *attr, const
     attr->texno = sprite_id;
 }
 #else
-static  __jo_force_inline void __jo_set_sprite_attributes(jo_vdp1_command * const cmd, const int sprite_id)
+/* Color mode, texture address and size (everything that depends on the sprite itself) */
+static  __jo_force_inline void __jo_set_sprite_texture(jo_vdp1_command * const cmd, const int sprite_id)
 {
-    cmd->ctrl |= __jo_sprite_attributes.direction;
-    cmd->pmod = 0x0080 | __jo_sprite_attributes.effect;
+    cmd->pmod &= ~(7 << 3);
     if (__jo_sprite_pic[sprite_id].color_mode == COL_32K)
     {
         cmd->pmod |= ((COLMODE_RGB & 7) << 3);
@@ -318,6 +400,13 @@ static  __jo_force_inline void __jo_set_sprite_attributes(jo_vdp1_command * cons
     cmd->srca = (unsigned int)(__jo_sprite_pic[sprite_id].data) >> 3;
     cmd->size = (((__jo_sprite_def[sprite_id].width >> 3) & 0x3F) << 8) |
                 (__jo_sprite_def[sprite_id].height & 0xFF);
+}
+
+static  __jo_force_inline void __jo_set_sprite_attributes(jo_vdp1_command * const cmd, const int sprite_id)
+{
+    cmd->ctrl |= __jo_sprite_attributes.direction;
+    cmd->pmod = 0x0080 | __jo_sprite_attributes.effect;
+    __jo_set_sprite_texture(cmd, sprite_id);
     if (__jo_sprite_attributes.effect & 4)
         cmd->grda = (JO_VDP1_VRAM + 0x70000 + JO_MULT_BY_8(__jo_gouraud_shading_runtime_index)) >> 3;
 }
@@ -475,6 +564,159 @@ void                    jo_sprite_draw_rotate(const int sprite_id, const jo_pos3
 #endif
 }
 
+/*
+** RETAINED SPRITES
+*/
+
+#if !JO_COMPILE_USING_SGL
+static  __jo_force_inline void  __jo_set_retained_sprite_position(jo_vdp1_command * const cmd, const jo_retained_sprite * const retained)
+{
+    cmd->xa = retained->x + JO_TV_WIDTH_2 - JO_DIV_BY_2(__jo_sprite_def[retained->sprite_id].width);
+    cmd->ya = retained->y + JO_TV_HEIGHT_2 - JO_DIV_BY_2(__jo_sprite_def[retained->sprite_id].height);
+}
+#endif
+
+int                         jo_sprite_retain(const int sprite_id, const int x, const int y, const int z)
+{
+    jo_retained_sprite      *retained;
+    int                     instance;
+#if !JO_COMPILE_USING_SGL
+    jo_vdp1_command         *cmd;
+#endif
+
+#if JO_COMPILE_USING_SGL
+    for (instance = 0; instance < JO_MAX_RETAINED_SPRITES && __jo_retained_sprites[instance].sprite_id >= 0; ++instance)
+        ;
+    if (instance >= JO_MAX_RETAINED_SPRITES)
+    {
+#ifdef JO_DEBUG
+        jo_core_error("Too many retained sprites (JO_MAX_RETAINED_SPRITES)");
+#endif
+        return (-1);
+    }
+    retained = &__jo_retained_sprites[instance];
+    retained->visible = true;
+    retained->attributes = __jo_sprite_attributes;
+#else
+    if ((instance = jo_vdp1_retain_command()) < 0)
+        return (-1);
+    retained = &__jo_retained_sprites[instance];
+#endif
+    retained->sprite_id = sprite_id;
+    retained->x = x;
+    retained->y = y;
+    retained->z = z;
+    retained->direction = __jo_sprite_attributes.direction & (16 | 32);
+#if !JO_COMPILE_USING_SGL
+    cmd = jo_vdp1_edit_retained_command(instance);
+    cmd->ctrl = DrawNormalSprite;
+    __jo_set_sprite_attributes(cmd, sprite_id);
+    cmd->jo_engine_reserved = z;
+    __jo_set_retained_sprite_position(cmd, retained);
+#endif
+    return (instance);
+}
+
+void                        jo_sprite_retained_set_position(const int instance, const int x, const int y)
+{
+    jo_retained_sprite      *retained;
+
+    retained = &__jo_retained_sprites[instance];
+    if (retained->x == x && retained->y == y)
+        return;
+    retained->x = x;
+    retained->y = y;
+#if !JO_COMPILE_USING_SGL
+    __jo_set_retained_sprite_position(jo_vdp1_edit_retained_command(instance), retained);
+#endif
+}
+
+void                        jo_sprite_retained_set_depth(const int instance, const int z)
+{
+    if (__jo_retained_sprites[instance].z == z)
+        return;
+    __jo_retained_sprites[instance].z = z;
+#if !JO_COMPILE_USING_SGL
+    jo_vdp1_edit_retained_command(instance)->jo_engine_reserved = z;
+#endif
+}
+
+void                        jo_sprite_retained_set_sprite(const int instance, const int sprite_id)
+{
+    jo_retained_sprite      *retained;
+#if !JO_COMPILE_USING_SGL
+    jo_vdp1_command         *cmd;
+#endif
+
+    retained = &__jo_retained_sprites[instance];
+    if (retained->sprite_id == sprite_id)
+        return;
+    retained->sprite_id = sprite_id;
+#if !JO_COMPILE_USING_SGL
+    cmd = jo_vdp1_edit_retained_command(instance);
+    __jo_set_sprite_texture(cmd, sprite_id);
+    __jo_set_retained_sprite_position(cmd, retained);
+#endif
+}
+
+void                        jo_sprite_retained_set_flip(const int instance, const bool horizontal, const bool vertical)
+{
+    unsigned short          direction;
+#if !JO_COMPILE_USING_SGL
+    jo_vdp1_command         *cmd;
+#endif
+
+    direction = (horizontal ? 16 : 0) | (vertical ? 32 : 0);
+    if (__jo_retained_sprites[instance].direction == direction)
+        return;
+    __jo_retained_sprites[instance].direction = direction;
+#if JO_COMPILE_USING_SGL
+    __jo_retained_sprites[instance].attributes.direction = (__jo_retained_sprites[instance].attributes.direction & ~(16 | 32)) | direction;
+#else
+    cmd = jo_vdp1_edit_retained_command(instance);
+    cmd->ctrl = (cmd->ctrl & ~(16 | 32)) | direction;
+#endif
+}
+
+void                        jo_sprite_retained_set_visible(const int instance, const bool visible)
+{
+#if JO_COMPILE_USING_SGL
+    __jo_retained_sprites[instance].visible = visible;
+#else
+    jo_vdp1_show_retained_command(instance, visible);
+#endif
+}
+
+void                        jo_sprite_release(const int instance)
+{
+    if (instance < 0 || __jo_retained_sprites[instance].sprite_id < 0)
+        return;
+    __jo_retained_sprites[instance].sprite_id = -1;
+#if !JO_COMPILE_USING_SGL
+    jo_vdp1_release_retained_command(instance);
+#endif
+}
+
+#if JO_COMPILE_USING_SGL
+void                        __jo_sprite_draw_retained(void)
+{
+    jo_sprite_attributes    attributes;
+    jo_retained_sprite      *retained;
+    int                     instance;
+
+    attributes = __jo_sprite_attributes;
+    for (instance = 0; instance < JO_MAX_RETAINED_SPRITES; ++instance)
+    {
+        retained = &__jo_retained_sprites[instance];
+        if (retained->sprite_id < 0 || !retained->visible)
+            continue;
+        __jo_sprite_attributes = retained->attributes;
+        jo_sprite_draw3D(retained->sprite_id, retained->x, retained->y, retained->z);
+    }
+    __jo_sprite_attributes = attributes;
+}
+#endif
+
 /*
 ** END OF FILE
 */
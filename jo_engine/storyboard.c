@@ -39,17 +39,17 @@
 #include "jo/tools.h"
 #include "jo/malloc.h"
 #include "jo/math.h"
+#include "jo/pool.h"
 #include "jo/list.h"
 #include "jo/storyboard.h"
 
 #ifdef JO_COMPILE_WITH_STORYBOARD_SUPPORT
 
-jo_list                             __storyboards;
+jo_intrusive_list                   __storyboards;
 
 void                                jo_init_storyboards(void)
 {
-    jo_list_init(&__storyboards);
-    jo_list_set_allocation_behaviour(&__storyboards, JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE);
+    jo_intrusive_list_init(&__storyboards);
 }
 
 jo_storyboard                       *jo_storyboard_create(const bool autoplay, const bool repeat)
@@ -58,17 +58,30 @@ jo_storyboard                       *jo_storyboard_create(const bool autoplay, c
 
     storyboard->pause = !autoplay;
     storyboard->repeat = repeat;
-    jo_list_init(&storyboard->objects);
-    jo_list_init(&storyboard->animations);
-    jo_list_add_ptr(&__storyboards, storyboard);
+    jo_intrusive_list_init(&storyboard->objects);
+    jo_intrusive_list_init(&storyboard->animations);
+    jo_intrusive_list_add(&__storyboards, &storyboard->link);
     return storyboard;
 }
 
+static void                         jo_storyboard_free_all(jo_intrusive_list * const list)
+{
+    jo_list_link                    *tmp;
+
+    /* link is the first member of every storyboard item */
+    while ((tmp = list->first) != JO_NULL)
+    {
+        jo_intrusive_list_remove(list, tmp);
+        jo_free(tmp);
+    }
+}
+
 void                                jo_storyboard_destroy(jo_storyboard * const storyboard)
 {
-    jo_list_free_and_clear(&storyboard->objects);
-    jo_list_free_and_clear(&storyboard->animations);
-    jo_list_remove_first_value(&__storyboards, (jo_list_data)(void *)storyboard);
+    jo_storyboard_free_all(&storyboard->objects);
+    jo_storyboard_free_all(&storyboard->animations);
+    jo_intrusive_list_remove(&__storyboards, &storyboard->link);
+    jo_free(storyboard);
 }
 
 static void                         animate_object(jo_animation * const animation, jo_storyboard_object_cache * const object)
@@ -117,28 +130,28 @@ static void                         animate_object(jo_animation * const animatio
 
 static void                         jo_reset_storyboard(jo_storyboard * const storyboard)
 {
-    jo_node                         *tmp;
+    jo_list_link                    *tmp;
 
     for (tmp = storyboard->animations.first; tmp != JO_NULL; tmp = tmp->next)
-        ((jo_animation *)tmp->data.ptr)->disabled = false;
+        JO_LIST_ENTRY(tmp, jo_animation, link)->disabled = false;
 }
 
 static void                         do_storyboard(jo_storyboard * const storyboard)
 {
-    jo_node                         *animation_node;
-    jo_node                         *object_node;
+    jo_list_link                    *animation_node;
+    jo_list_link                    *object_node;
     jo_animation                    *animation;
 
     for (animation_node = storyboard->animations.first; animation_node != JO_NULL; animation_node = animation_node->next)
     {
-        animation = (jo_animation *)animation_node->data.ptr;
+        animation = JO_LIST_ENTRY(animation_node, jo_animation, link);
         if (animation->disabled)
             continue;
         if (animation->frame >= animation->frame_skip)
         {
             JO_ZERO(animation->frame);
             for (object_node = storyboard->objects.first; object_node != JO_NULL; object_node = object_node->next)
-                animate_object(animation, (jo_storyboard_object_cache *)object_node->data.ptr);
+                animate_object(animation, JO_LIST_ENTRY(object_node, jo_storyboard_object_cache, link));
             if (animation->limit)
             {
                 ++animation->count;
@@ -160,12 +173,12 @@ static void                         do_storyboard(jo_storyboard * const storyboa
 
 void                                jo_execute_storyboards(void)
 {
-    jo_node                         *storyboard_node;
+    jo_list_link                    *storyboard_node;
     jo_storyboard                   *storyboard;
 
     for (storyboard_node = __storyboards.first; storyboard_node != JO_NULL; storyboard_node = storyboard_node->next)
     {
-        storyboard = (jo_storyboard *)storyboard_node->data.ptr;
+        storyboard = JO_LIST_ENTRY(storyboard_node, jo_storyboard, link);
         if (!storyboard->pause && storyboard->objects.count)
             do_storyboard(storyboard);
     }
@@ -180,7 +193,7 @@ jo_animation                        *jo_storyboard_create_animation(jo_storyboar
     jo_memset(tmp, 0, sizeof(*tmp));
     tmp->frame_skip = frame_skip;
     tmp->limit = duration;
-    jo_list_add_ptr(&storyboard->animations, tmp);
+    jo_intrusive_list_add(&storyboard->animations, &tmp->link);
     return tmp;
 }
 
@@ -93,8 +93,8 @@ t_tga_error_code	__jo_tga_load(jo_img *img, const char * const sub_dir, const ch
 #endif /* !JO_COMPILE_WITH_FS_SUPPORT */
     if (*stream == JO_NULL)
         return (JO_TGA_UNSUPPORTED_FORMAT);
-    img->width = jo_swap_endian_ushort( *((unsigned short *)(*stream + TGA_HEADER_INDEX_WIDTH)));
-    img->height = jo_swap_endian_ushort( *((unsigned short *)(*stream + TGA_HEADER_INDEX_HEIGHT)));
+    img->width = jo_little_endian_to_ushort( *((unsigned short *)(*stream + TGA_HEADER_INDEX_WIDTH)));
+    img->height = jo_little_endian_to_ushort( *((unsigned short *)(*stream + TGA_HEADER_INDEX_HEIGHT)));
     *bits = (int)(*stream)[TGA_HEADER_INDEX_BITSPERPIXEL];
     if (!JO_TGA_SUPPORTED_FORMAT(*bits))
     {
@@ -106,7 +106,7 @@ t_tga_error_code	__jo_tga_load(jo_img *img, const char * const sub_dir, const ch
         return (JO_TGA_UNSUPPORTED_FORMAT);
     }
     if (img->data == JO_NULL)
-        img->data = (unsigned short *)jo_malloc_with_behaviour(img->height * img->width * sizeof(*img->data), JO_MALLOC_TRY_REUSE_BLOCK);
+        img->data = (unsigned short *)jo_malloc_with_placement(img->height * img->width * sizeof(*img->data), JO_MALLOC_TRY_REUSE_BLOCK, JO_ZONE_PREFER_BULK);
     if (img->data == JO_NULL)
     {
 #ifdef JO_DEBUG
@@ -209,7 +209,7 @@ int		                    jo_sprite_add_tga_tileset(const char * const sub_dir, c
 #endif
         tile_image.width = tileset[i].width;
         tile_image.height = tileset[i].height;
-        tile_image.data = (unsigned short *)jo_malloc(tile_image.height * tile_image.width * sizeof(*tile_image.data));
+        tile_image.data = (unsigned short *)jo_malloc_with_placement(tile_image.height * tile_image.width * sizeof(*tile_image.data), JO_FAST_ALLOCATION, JO_ZONE_PREFER_BULK);
         if (tile_image.data == JO_NULL)
         {
 #ifdef JO_DEBUG
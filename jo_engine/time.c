@@ -57,7 +57,7 @@ static  __jo_force_inline int jo_time_frame_count_to_mcr(int count)
     return ((((*(Uint16 *)0x25f80004 & 0x1) == 0x1) ?
              ((jo_time_get_sys_clock_value() == 0) ? (float)0.037470726 : (float)0.035164835 ) :
              ((jo_time_get_sys_clock_value() == 0) ? (float)0.037210548 : (float)0.03492059 ))
-            * (count) * (8 << ((jo_time_peek_byte(RegisterTCR) & JO_TIME_M_CKS) << 1)));
+            * (count) * jo_time_get_frc_cycles_per_tick());
 }
 
 unsigned int                jo_get_ticks(void)
@@ -40,133 +40,343 @@
 #include "jo/math.h"
 #include "jo/tools.h"
 #include "jo/malloc.h"
+#include "jo/pool.h"
 #include "jo/list.h"
 #include "jo/vdp1_command_pipeline.h"
+#include "jo/sprites.h"
 
 #if !JO_COMPILE_USING_SGL
 
-#define JO_COMMAND_TABLE_COUNT   (16)
-#define JO_COMMAND_TABLE_SIZE   (sizeof(jo_vdp1_command) * JO_COMMAND_TABLE_COUNT)
+/* Two command lists in VDP1 VRAM: the VDP1 draws one while the next frame is uploaded to the other */
+#if 2 * JO_VDP1_MAX_COMMANDS * 32 > JO_VDP1_TEXTURE_DEF_BASE_ADDRESS
+# error "JO_VDP1_MAX_COMMANDS overlaps the sprite area in VDP1 VRAM"
+#endif
+
+/* The first commands (clipping and local coordinates) are never sorted */
+#define JO_VDP1_FIRST_SORTED_COMMAND    (3)
+#define JO_VDP1_JUMP_MASK               (0x7000)
+#define JO_VDP1_JUMP_ASSIGN             (0x1000)
+#define JO_VDP1_JUMP_SKIP_ASSIGN        (0x5000)
+
+/* Retained commands live at the end of each list (see jo_vdp1_retain_command()) */
+#define JO_VDP1_RETAINED_COMMANDS       (JO_MAX_RETAINED_SPRITES)
+#define JO_VDP1_FIRST_RETAINED_COMMAND  (JO_VDP1_MAX_COMMANDS - JO_VDP1_RETAINED_COMMANDS)
+
+#if JO_VDP1_FIRST_RETAINED_COMMAND <= JO_VDP1_FIRST_SORTED_COMMAND + 1
+# error "JO_MAX_RETAINED_SPRITES is too big for JO_VDP1_MAX_COMMANDS"
+#endif
+
+#define JO_VDP1_RETAINED_USED           (1)
+#define JO_VDP1_RETAINED_VISIBLE        (2)
+/* Shifted by the list index */
+#define JO_VDP1_RETAINED_DIRTY          (4)
 
 /*
 ** GLOBALS
 */
 
-static jo_list                  __jo_vdp1_buffer;
-static unsigned int             __jo_vdp1_current_table_size = 0;
-static unsigned int             __jo_vdp1_max_runtime_tables = 0;
+unsigned int                    __jo_vdp1_command_index = 0;
+/* Command buffer (JO_VDP1_MAX_COMMANDS entries), copy of the retained commands in each VRAM list and depth sort scratch (3 x JO_VDP1_MAX_COMMANDS) */
+static jo_vdp1_command          *__jo_vdp1_commands = JO_NULL;
+static jo_vdp1_command          *__jo_vdp1_retained_shadow = JO_NULL;
+static unsigned short           *__jo_vdp1_sort_keys = JO_NULL;
+static unsigned short           *__jo_vdp1_sort_indexes = JO_NULL;
+static unsigned short           *__jo_vdp1_sort_tmp = JO_NULL;
+/* Returned by jo_vdp1_create_command() when the buffer is full, never sent to the VDP1 */
+static jo_vdp1_command          __jo_vdp1_overflow_command;
+#ifdef JO_DEBUG
+static unsigned int             __jo_vdp1_dropped_command_count = 0;
+#endif
+/* VRAM list (0 or 1) that receives the next jo_vdp1_flush() */
+static unsigned int             __jo_vdp1_back_list = 0;
+static unsigned char            __jo_vdp1_retained_flags[JO_VDP1_RETAINED_COMMANDS];
+static unsigned int             __jo_vdp1_retained_visible_count = 0;
 
-static jo_vdp1_command          *__jo_create_new_command_table(void)
+void                            jo_vdp1_buffer_init(void)
 {
-    jo_vdp1_command             *command_table;
-
-    if ((command_table = jo_malloc_with_behaviour(JO_COMMAND_TABLE_SIZE, JO_MALLOC_TRY_REUSE_SAME_BLOCK_SIZE)) == JO_NULL)
+    if ((__jo_vdp1_commands = (jo_vdp1_command *)jo_malloc((JO_VDP1_MAX_COMMANDS + 2 * JO_VDP1_RETAINED_COMMANDS) * sizeof(jo_vdp1_command) +
+                                                           JO_VDP1_MAX_COMMANDS * 3 * sizeof(unsigned short))) == JO_NULL)
     {
 #ifdef JO_DEBUG
         jo_core_error("Out of memory");
 #endif
-        return JO_NULL;
+        return;
     }
-    jo_list_add_ptr(&__jo_vdp1_buffer, command_table);
-    jo_memset(command_table, 0xFFFF, JO_COMMAND_TABLE_SIZE);
-    JO_ZERO(__jo_vdp1_current_table_size);
-    return command_table;
-}
-
-void                            jo_vdp1_buffer_init(void)
-{
-    jo_list_init(&__jo_vdp1_buffer);
-    __jo_create_new_command_table();
+    __jo_vdp1_retained_shadow = __jo_vdp1_commands + JO_VDP1_MAX_COMMANDS;
+    __jo_vdp1_sort_keys = (unsigned short *)(__jo_vdp1_retained_shadow + 2 * JO_VDP1_RETAINED_COMMANDS);
+    __jo_vdp1_sort_indexes = __jo_vdp1_sort_keys + JO_VDP1_MAX_COMMANDS;
+    __jo_vdp1_sort_tmp = __jo_vdp1_sort_indexes + JO_VDP1_MAX_COMMANDS;
+    JO_ZERO(__jo_vdp1_command_index);
 }
 
 jo_vdp1_command*                jo_vdp1_create_command(void)
 {
-    jo_vdp1_command             *command_table;
-
-    if (__jo_vdp1_current_table_size >= JO_COMMAND_TABLE_COUNT)
-        command_table = __jo_create_new_command_table();
-    else
-        command_table = (jo_vdp1_command *)__jo_vdp1_buffer.last->data.ptr;
-    return &command_table[__jo_vdp1_current_table_size++];
+    /* The last entry is kept for the end command */
+    if (__jo_vdp1_command_index >= JO_VDP1_FIRST_RETAINED_COMMAND - 1)
+    {
+#ifdef JO_DEBUG
+        ++__jo_vdp1_dropped_command_count;
+#endif
+        return &__jo_vdp1_overflow_command;
+    }
+    return &__jo_vdp1_commands[__jo_vdp1_command_index++];
 }
 
 void                            jo_vdp1_buffer_reset(void)
 {
-    jo_vdp1_command             *command_table;
+    jo_vdp1_command             *command;
 
-    JO_ZERO(__jo_vdp1_current_table_size);
-    while (__jo_vdp1_buffer.count > 1)
-        jo_list_free_and_remove_last(&__jo_vdp1_buffer);
+    JO_ZERO(__jo_vdp1_command_index);
+    if (__jo_vdp1_commands == JO_NULL)
+        return;
     // system clipping
-    command_table = jo_vdp1_create_command();
-    jo_memset(command_table, 0xFFFF, JO_COMMAND_TABLE_SIZE);
-    command_table->ctrl = SetSystemClipping;
-    command_table->xc = JO_TV_WIDTH;
-    command_table->yc = JO_TV_HEIGHT;
+    command = jo_vdp1_create_command();
+    command->ctrl = SetSystemClipping;
+    command->xc = JO_TV_WIDTH;
+    command->yc = JO_TV_HEIGHT;
     // user clipping
-    command_table = jo_vdp1_create_command();
-    command_table->ctrl = SetUserClipping;
-    JO_ZERO(command_table->xa);
-    JO_ZERO(command_table->ya);
-    command_table->xc = JO_TV_WIDTH;
-    command_table->yc = JO_TV_HEIGHT;
+    command = jo_vdp1_create_command();
+    command->ctrl = SetUserClipping;
+    JO_ZERO(command->xa);
+    JO_ZERO(command->ya);
+    command->xc = JO_TV_WIDTH;
+    command->yc = JO_TV_HEIGHT;
     // local coordinates
-    command_table = jo_vdp1_create_command();
-    command_table->ctrl = SetLocalCoordinates;
-    JO_ZERO(command_table->xc);
-    JO_ZERO(command_table->yc);
+    command = jo_vdp1_create_command();
+    command->ctrl = SetLocalCoordinates;
+    JO_ZERO(command->xc);
+    JO_ZERO(command->yc);
 }
 
-/*static void                     __jo_vdp1_sort_commands(void)
+/*
+** RETAINED COMMANDS
+*/
+
+int                             jo_vdp1_retain_command(void)
 {
-    bool                        done;
-    jo_node                     *n;
-#if JO_COMMAND_TABLE_COUNT > (1)
-    int                         i;
+    int                         slot;
+
+    if (__jo_vdp1_commands == JO_NULL)
+        return (-1);
+    for (slot = 0; slot < JO_VDP1_RETAINED_COMMANDS; ++slot)
+    {
+        if (__jo_vdp1_retained_flags[slot] & JO_VDP1_RETAINED_USED)
+            continue;
+        __jo_vdp1_retained_flags[slot] = JO_VDP1_RETAINED_USED | JO_VDP1_RETAINED_VISIBLE | (JO_VDP1_RETAINED_DIRTY << 0) | (JO_VDP1_RETAINED_DIRTY << 1);
+        ++__jo_vdp1_retained_visible_count;
+        jo_memset(&__jo_vdp1_commands[JO_VDP1_FIRST_RETAINED_COMMAND + slot], 0, sizeof(jo_vdp1_command));
+        return (slot);
+    }
+#ifdef JO_DEBUG
+    jo_core_error("Too many retained VDP1 commands (JO_MAX_RETAINED_SPRITES)");
 #endif
-    do
+    return (-1);
+}
+
+jo_vdp1_command                 *jo_vdp1_edit_retained_command(const int slot)
+{
+    __jo_vdp1_retained_flags[slot] |= (JO_VDP1_RETAINED_DIRTY << 0) | (JO_VDP1_RETAINED_DIRTY << 1);
+    return &__jo_vdp1_commands[JO_VDP1_FIRST_RETAINED_COMMAND + slot];
+}
+
+void                            jo_vdp1_show_retained_command(const int slot, const bool visible)
+{
+    if (!(__jo_vdp1_retained_flags[slot] & JO_VDP1_RETAINED_USED) ||
+        visible == ((__jo_vdp1_retained_flags[slot] & JO_VDP1_RETAINED_VISIBLE) != 0))
+        return;
+    if (visible)
     {
-        done = true;
-        for (n = __jo_vdp1_buffer.first; n->next != JO_NULL; n = n->next)
-        {
-#if JO_COMMAND_TABLE_COUNT > (1)
+        __jo_vdp1_retained_flags[slot] |= JO_VDP1_RETAINED_VISIBLE;
+        ++__jo_vdp1_retained_visible_count;
+    }
+    else
+    {
+        __jo_vdp1_retained_flags[slot] &= ~JO_VDP1_RETAINED_VISIBLE;
+        --__jo_vdp1_retained_visible_count;
+    }
+}
 
-            for (i = 0; i < JO_COMMAND_TABLE_COUNT; ++i)
-            {
+void                            jo_vdp1_release_retained_command(const int slot)
+{
+    jo_vdp1_show_retained_command(slot, false);
+    JO_ZERO(__jo_vdp1_retained_flags[slot]);
+}
 
-            }
-#else
-            if (((jo_vdp1_command *)n->data.ptr)->jo_engine_reserved < ((jo_vdp1_command *)n->next->data.ptr)->jo_engine_reserved)
+/* Write the words of the visible retained commands that differ from what the list already holds in VRAM.
+** An edited (or newly retained) command is written whole, which also makes the shadow match VRAM.
+** Otherwise, only CMDCTRL and CMDLINK (depth sort) are compared.
+*/
+static void                     __jo_vdp1_upload_retained_commands(const unsigned int vram_index)
+{
+    unsigned short              *src;
+    unsigned short              *shadow;
+    volatile unsigned short     *dst;
+    unsigned int                i;
+    int                         slot;
+
+    for (slot = 0; slot < JO_VDP1_RETAINED_COMMANDS; ++slot)
+    {
+        if (!(__jo_vdp1_retained_flags[slot] & JO_VDP1_RETAINED_VISIBLE))
+            continue;
+        src = (unsigned short *)&__jo_vdp1_commands[JO_VDP1_FIRST_RETAINED_COMMAND + slot];
+        shadow = (unsigned short *)&__jo_vdp1_retained_shadow[__jo_vdp1_back_list * JO_VDP1_RETAINED_COMMANDS + slot];
+        dst = (volatile unsigned short *)jo_vdp1_get_command_entry(vram_index + JO_VDP1_FIRST_RETAINED_COMMAND + slot);
+        if (__jo_vdp1_retained_flags[slot] & (JO_VDP1_RETAINED_DIRTY << __jo_vdp1_back_list))
+        {
+            __jo_vdp1_retained_flags[slot] &= ~(JO_VDP1_RETAINED_DIRTY << __jo_vdp1_back_list);
+            for (i = 0; i < sizeof(jo_vdp1_command) / sizeof(unsigned short); ++i)
             {
-                done = false;
-                JO_SWAP(n->data.integer, n->next->data.integer);
+                shadow[i] = src[i];
+                dst[i] = src[i];
             }
-#endif
+            continue;
+        }
+        for (i = 0; i < 2; ++i)
+        {
+            if (src[i] == shadow[i])
+                continue;
+            shadow[i] = src[i];
+            dst[i] = src[i];
         }
     }
-    while (!done);
-}*/
+}
+
+/*
+** DEPTH SORT
+*/
+
+/* Stable LSD radix pass on one byte of the key. Returns false when every key shares the same byte (nothing to do) */
+static bool                     __jo_vdp1_radix_pass(const unsigned short * const keys, const unsigned short * const src, unsigned short * const dst,
+                                                     const unsigned int count, const unsigned int shift)
+{
+    unsigned short              offsets[256];
+    unsigned int                i;
+    unsigned int                sum;
+    unsigned int                bucket_count;
+
+    for (i = 0; i < 256; ++i)
+        JO_ZERO(offsets[i]);
+    for (i = 0; i < count; ++i)
+        ++offsets[(keys[src[i]] >> shift) & 0xFF];
+    for (i = 0, sum = 0; i < 256; ++i)
+    {
+        bucket_count = offsets[i];
+        if (bucket_count == count)
+            return false;
+        offsets[i] = sum;
+        sum += bucket_count;
+    }
+    for (i = 0; i < count; ++i)
+        dst[offsets[(keys[src[i]] >> shift) & 0xFF]++] = src[i];
+    return true;
+}
+
+/* Sort commands by depth (jo_engine_reserved) in O(n), farthest first (like SGL, bigger Z is farther).
+** Commands are never moved in memory: they are chained in sorted order using CMDCTRL jump assign and CMDLINK.
+** Commands with the same depth are kept in creation order, visible retained commands come after the others.
+** Links are relative to vram_index (first VRAM entry of the list).
+*/
+static void                     __jo_vdp1_sort_commands(const unsigned int vram_index)
+{
+    jo_vdp1_command             *commands;
+    jo_vdp1_command             *command;
+    unsigned short              *keys;
+    unsigned short              *sorted;
+    unsigned short              *tmp;
+    unsigned short              *swap;
+    unsigned int                count;
+    unsigned int                i;
+    unsigned int                shift;
+    int                         slot;
+    bool                        already_sorted;
+
+    commands = __jo_vdp1_commands + JO_VDP1_FIRST_SORTED_COMMAND;
+    keys = __jo_vdp1_sort_keys;
+    sorted = __jo_vdp1_sort_indexes;
+    tmp = __jo_vdp1_sort_tmp;
+    /* Descending signed depth mapped to ascending unsigned key, indexed from JO_VDP1_FIRST_SORTED_COMMAND */
+    already_sorted = true;
+    for (count = 0, i = 0; i < __jo_vdp1_command_index - JO_VDP1_FIRST_SORTED_COMMAND; ++i)
+    {
+        keys[i] = ((unsigned short)commands[i].jo_engine_reserved) ^ 0x7FFF;
+        sorted[count++] = i;
+        if (i && keys[i] < keys[i - 1])
+            already_sorted = false;
+    }
+    /* Retained commands are after the end command so they are only reached by jumps */
+    for (slot = 0; __jo_vdp1_retained_visible_count && slot < JO_VDP1_RETAINED_COMMANDS; ++slot)
+    {
+        if (!(__jo_vdp1_retained_flags[slot] & JO_VDP1_RETAINED_VISIBLE))
+            continue;
+        i = JO_VDP1_FIRST_RETAINED_COMMAND - JO_VDP1_FIRST_SORTED_COMMAND + slot;
+        keys[i] = ((unsigned short)commands[i].jo_engine_reserved) ^ 0x7FFF;
+        sorted[count++] = i;
+    }
+    if (!count || (already_sorted && !__jo_vdp1_retained_visible_count))
+        return;
+    for (shift = 0; shift < 16; shift += 8)
+    {
+        if (!__jo_vdp1_radix_pass(keys, sorted, tmp, count, shift))
+            continue;
+        swap = sorted;
+        sorted = tmp;
+        tmp = swap;
+    }
+    command = commands - 1;
+    for (i = 0; i < count; ++i)
+    {
+        command->ctrl = (command->ctrl & ~JO_VDP1_JUMP_MASK) | JO_VDP1_JUMP_ASSIGN;
+        command->link = JO_MULT_BY_4(vram_index + sorted[i] + JO_VDP1_FIRST_SORTED_COMMAND);
+        command = commands + sorted[i];
+    }
+    /* The last sorted command jumps to the end command */
+    command->ctrl = (command->ctrl & ~JO_VDP1_JUMP_MASK) | JO_VDP1_JUMP_ASSIGN;
+    command->link = JO_MULT_BY_4(vram_index + __jo_vdp1_command_index);
+}
 
+/* The VDP1 always starts at the first VRAM entry, which is the system clipping command of list 0.
+** Uploading list 0 restores it, selecting list 1 turns it into a jump (skip assign) to list 1.
+** The VDP1 reads it once at the beginning of each frame, so it is only rewritten once the DMA is done:
+** the VDP1 never starts a list which is still being uploaded.
+*/
 void                            jo_vdp1_flush(void)
 {
-    jo_node                     *node;
-    unsigned char               *vdp1_vram_addr;
-    int                         fill;
+    jo_vdp1_command             *entry;
+    unsigned int                vram_index;
+    unsigned int                first;
 
-    //__jo_vdp1_sort_commands();
-    vdp1_vram_addr = (unsigned char *)JO_VDP1_VRAM;
-    for (node = __jo_vdp1_buffer.first; node != JO_NULL; node = node->next)
+    if (__jo_vdp1_commands == JO_NULL)
+        return;
+#ifdef JO_DEBUG
+    if (__jo_vdp1_dropped_command_count)
     {
-        jo_dma_copy(node->data.ptr, vdp1_vram_addr, JO_COMMAND_TABLE_SIZE);
-        vdp1_vram_addr += JO_COMMAND_TABLE_SIZE;
+        jo_core_error("Too many VDP1 commands: %d not displayed (JO_VDP1_MAX_COMMANDS)", __jo_vdp1_dropped_command_count);
+        JO_ZERO(__jo_vdp1_dropped_command_count);
     }
-    if (__jo_vdp1_max_runtime_tables)
+#endif
+    vram_index = __jo_vdp1_back_list * JO_VDP1_MAX_COMMANDS;
+    __jo_vdp1_sort_commands(vram_index);
+    /* Always room for it (see jo_vdp1_create_command()) */
+    __jo_vdp1_commands[__jo_vdp1_command_index].ctrl = DrawEnd;
+    /* The first entry of list 0 is written by the CPU after the DMA */
+    first = vram_index ? 0 : 1;
+    jo_dma_copy(__jo_vdp1_commands + first, jo_vdp1_get_command_entry(vram_index + first), (__jo_vdp1_command_index + 1 - first) * sizeof(jo_vdp1_command));
+    if (__jo_vdp1_retained_visible_count)
+        __jo_vdp1_upload_retained_commands(vram_index);
+    jo_dma_wait();
+    entry = jo_vdp1_get_command_entry(0);
+    if (vram_index)
+    {
+        entry->link = JO_MULT_BY_4(vram_index);
+        entry->ctrl = SetSystemClipping | JO_VDP1_JUMP_SKIP_ASSIGN;
+    }
+    else
     {
-        fill = __jo_vdp1_max_runtime_tables - __jo_vdp1_buffer.count;
-        if (fill > 0)
-            jo_memset(vdp1_vram_addr, 0xFFFF, JO_COMMAND_TABLE_SIZE * fill);
+        entry->xc = __jo_vdp1_commands[0].xc;
+        entry->yc = __jo_vdp1_commands[0].yc;
+        entry->ctrl = __jo_vdp1_commands[0].ctrl;
     }
-    __jo_vdp1_max_runtime_tables = __jo_vdp1_buffer.count;
+    __jo_vdp1_back_list ^= 1;
 }
 
 #endif
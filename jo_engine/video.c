@@ -141,7 +141,7 @@ bool					jo_video_open_file(const char *const filename)
 #endif
         return (false);
     }
-    if ((__jo_video_cpk.movie_buffer = jo_malloc_with_behaviour(RING_BUF_SIZ, JO_MALLOC_TRY_REUSE_BLOCK)) == JO_NULL)
+    if ((__jo_video_cpk.movie_buffer = jo_malloc_with_placement(RING_BUF_SIZ, JO_MALLOC_TRY_REUSE_BLOCK, JO_ZONE_PREFER_BULK)) == JO_NULL)
     {
 #ifdef JO_DEBUG
         jo_core_error("%s: Out of memory #1", filename);
@@ -31,6 +31,19 @@
 
 #define CD_LOOP 1     
 #define TRACK_LEVEL1 2 //1st level BGM 
+#define MAX_LASER_BLASTS 3
+#define MAX_ENEMIES 64
+#define MAX_ENEMY_BULLETS 1024
+/* Only the center of the ship is vulnerable to bullets */
+#define SHIP_CORE_SIZE 8
+/* Depth (Z index): bigger is farther, so draw calls no longer need to be made back to front.
+   The fog (water) stays in front of everything and the enemies, bullets and shield behind the ship */
+#define WATER_DEPTH 400
+#define SHIP_DEPTH 500
+#define ENTITY_DEPTH 520
+#define WATER_TILE_COUNT 4
+/* Enemies use collider indexes [0, MAX_ENEMIES[ and laser blasts the following ones */
+#define MAX_COLLIDERS (MAX_ENEMIES + MAX_LASER_BLASTS)
 
 static t_ship       ship;
 static int          first_ship_sprite_id;
@@ -38,26 +51,52 @@ static int          blast_sprite_id;
 static int          enemy_sprite_id;
 //static int        enemy2_sprite_id; SOON
 static int          shield_sprite_id;
-static jo_list      laser_blast_list;
-static jo_list      enemies_list;
+static jo_entity_store  laser_blasts;
+static jo_entity_store  enemies;
+static jo_entity_store  enemy_bullets;
+static jo_bullet_emitter bullet_emitter;
+static jo_collision_sap colliders_sap;
+static jo_aabb          colliders[MAX_COLLIDERS];
 static int          level = 0;
 static int          gameover = 0;
 static char         having_shield = 1;
+/* Retained sprites: drawn every frame by the engine, we only update what changes */
+static int          water[WATER_TILE_COUNT];
+static int          ship_instance;
+static int          shield_instance;
 static int          water_sprite_id = 0;
 static jo_sound     blop;
 
-static jo_datetime cow;
-
-void draw_water(int sprite_id, int sprite_height, int speed)
+static const unsigned char bullet_script[] =
 {
-    static int water_pos_y = 0;
+    /* 0 */ JO_BULLET_WAIT(120),
+    /* 1 */ JO_BULLET_SPIRAL(4, JO_BULLET_SPEED(1.5), 11, 0),
+    /* 2 */ JO_BULLET_WAIT(6),
+    /* 3 */ JO_BULLET_LOOP(1, 30),
+    /* 4 */ JO_BULLET_AIMED(5, JO_BULLET_SPEED(2.5), 12, 0),
+    /* 5 */ JO_BULLET_WAVE(8, JO_BULLET_SPEED(1), 15, 30, 90),
+    /* 6 */ JO_BULLET_WAIT(8),
+    /* 7 */ JO_BULLET_LOOP(5, 20),
+    /* 8 */ JO_BULLET_LOOP(1, 0),
+};
+
+void retain_water(int sprite_id)
+{
+    int i;
 
     jo_sprite_enable_half_transparency();
-    jo_sprite_draw3D(sprite_id, 0, water_pos_y - sprite_height - sprite_height, 400);
-    jo_sprite_draw3D(sprite_id, 0, water_pos_y - sprite_height, 400);
-    jo_sprite_draw3D(sprite_id, 0, water_pos_y, 400);
-    jo_sprite_draw3D(sprite_id, 0, water_pos_y + sprite_height, 400);
+    for (i = 0; i < WATER_TILE_COUNT; ++i)
+        water[i] = jo_sprite_retain(sprite_id, 0, 0, WATER_DEPTH);
     jo_sprite_disable_half_transparency();
+}
+
+void draw_water(int sprite_height, int speed)
+{
+    static int water_pos_y = 0;
+    int i;
+
+    for (i = 0; i < WATER_TILE_COUNT; ++i)
+        jo_sprite_retained_set_position(water[i], 0, water_pos_y + (i - 2) * sprite_height);
     water_pos_y += speed;
     if (water_pos_y > sprite_height)
         water_pos_y = 0;
@@ -76,13 +115,14 @@ void gimme_date (void) {
 void                next_level(void)
 {
     int             i;
-    jo_list_data    enemy_spec;
+    int             x;
+    int             y;
 
-    for (i = level; i >= 0; --i)
+    for (i = level; i >= 0 && enemies.count < MAX_ENEMIES; --i)
     {
-        enemy_spec.coord.x = (jo_random(2) == 1 ? jo_random_using_multiple(141, 32) : -jo_random_using_multiple(141, 32));
-        enemy_spec.coord.y = -JO_TV_HEIGHT_2 - jo_random_using_multiple(120, 40);
-        jo_list_add(&enemies_list, enemy_spec);
+        x = (jo_random(2) == 1 ? jo_random_using_multiple(141, 32) : -jo_random_using_multiple(141, 32));
+        y = -JO_TV_HEIGHT_2 - jo_random_using_multiple(120, 40);
+        jo_entity_spawn(&enemies, JO_MULT_BY_65536(x), JO_MULT_BY_65536(y), 0, JO_MULT_BY_65536(2), enemy_sprite_id);
     }
     ++level;
 }
@@ -90,57 +130,86 @@ void                next_level(void)
 static inline void         draw_ship(void)
 {
     /* Instead of loading the same animation when we move the ship to the right, we just flip the sprite horizontally */
-    if (ship.move == SHIP_MOVE_RIGHT)
-        jo_sprite_enable_horizontal_flip();
+    jo_sprite_retained_set_flip(ship_instance, ship.move == SHIP_MOVE_RIGHT, false);
     /* We reverse the animation when the ship doesn't move horizontally (see line 74) */
-    jo_sprite_draw3D(ship.reverse_animation ? jo_get_anim_sprite_reverse(ship.anim_id) : jo_get_anim_sprite(ship.anim_id), ship.x, ship.y, 500);
-    if (ship.move == SHIP_MOVE_RIGHT)
-        jo_sprite_disable_horizontal_flip();
-
+    jo_sprite_retained_set_sprite(ship_instance, ship.reverse_animation ? jo_get_anim_sprite_reverse(ship.anim_id) : jo_get_anim_sprite(ship.anim_id));
+    jo_sprite_retained_set_position(ship_instance, ship.x, ship.y);
 }
 
-static inline bool         check_if_laser_hit_enemy(jo_node *enemy, void *extra)
+static inline void         update_colliders(void)
 {
-    jo_node         *blast;
+    int             i;
 
-    blast = (jo_node *)extra;
-    if (!jo_hitbox_detection_custom_boundaries(blast_sprite_id, blast->data.coord.x, blast->data.coord.y, enemy->data.coord.x, enemy->data.coord.y, 20, 24))
-        return false;
-    jo_list_remove(&enemies_list, enemy);
+    /* Dead entities get an empty box so each entity keeps the same collider index from one frame to the next */
+    for (i = 0; i < MAX_ENEMIES; ++i)
+        if (jo_entity_is_alive(&enemies, i))
+            jo_hitbox_get_aabb(enemy_sprite_id, jo_entity_get_x(&enemies, i), jo_entity_get_y(&enemies, i), &colliders[i]);
+        else
+            colliders[i].width = 0;
+    for (i = 0; i < MAX_LASER_BLASTS; ++i)
+        if (jo_entity_is_alive(&laser_blasts, i))
+            jo_hitbox_get_aabb(blast_sprite_id, jo_entity_get_x(&laser_blasts, i), jo_entity_get_y(&laser_blasts, i), &colliders[MAX_ENEMIES + i]);
+        else
+            colliders[MAX_ENEMIES + i].width = 0;
+}
+
+static inline void         check_if_laser_hit_enemy(const int enemy, const int collider, void *extra)
+{
+    int             blast;
+
+    blast = collider - MAX_ENEMIES;
+    /* Skip enemy/enemy and laser/laser pairs */
+    if (enemy >= MAX_ENEMIES || blast < 0)
+        return;
+    /* Each laser blast kills only one enemy */
+    if (!jo_entity_is_alive(&enemies, enemy) || !jo_entity_is_alive(&laser_blasts, blast))
+        return;
+    jo_entity_kill(&enemies, enemy);
+    jo_entity_kill(&laser_blasts, blast);
     ++ship.score;
     if (ship.score > ship.hiScore)
     {
         ++ship.hiScore; //begin incrementing the new HiScore
     }
-    return true;
 }
 
-static inline void         draw_laser_blast(jo_node *node)
+static inline void         draw_entity(jo_entity_store * const store, const int index)
 {
-    jo_sprite_draw3D(blast_sprite_id, node->data.coord.x, node->data.coord.y, 520);
-    node->data.coord.y -= 4;
-    if (jo_list_any(&enemies_list, check_if_laser_hit_enemy, node))
-        jo_list_remove(&laser_blast_list, node);
-    else if (node->data.coord.y < -JO_TV_HEIGHT_2)
-        jo_list_remove(&laser_blast_list, node);
+    jo_sprite_draw3D(store->sprite[index], jo_entity_get_x(store, index), jo_entity_get_y(store, index), ENTITY_DEPTH);
 }
 
-static inline void         draw_enemy(jo_node *node)
+static inline void         check_enemy_bullets(void)
 {
-    jo_sprite_draw3D(enemy_sprite_id, node->data.coord.x, node->data.coord.y, 520);
-    node->data.coord.y += 2;
-    if (having_shield && jo_hitbox_detection(enemy_sprite_id, node->data.coord.x, node->data.coord.y, shield_sprite_id, ship.shield_pos.x, ship.shield_pos.y))
+    jo_aabb         shield;
+
+    /* The shield absorbs bullets */
+    if (having_shield)
+    {
+        jo_hitbox_get_aabb(shield_sprite_id, ship.x + ship.shield_pos.x, ship.y + ship.shield_pos.y, &shield);
+        jo_entity_store_kill_inside(&enemy_bullets, shield.x, shield.y, shield.x + shield.width, shield.y + shield.height);
+    }
+    if (jo_entity_store_kill_inside(&enemy_bullets, ship.x - SHIP_CORE_SIZE / 2, ship.y - SHIP_CORE_SIZE / 2,
+                                    ship.x + SHIP_CORE_SIZE / 2, ship.y + SHIP_CORE_SIZE / 2) > 0)
+        gameover = 1;
+}
+
+static inline void         check_enemy(jo_entity_store * const store, const int enemy)
+{
+    /* EN.HIT only shrinks the box used against the ship: the shield still stops the whole enemy sprite */
+    if (having_shield && jo_hitbox_detection_custom_boundaries(shield_sprite_id, ship.x + ship.shield_pos.x, ship.y + ship.shield_pos.y,
+                                                               jo_entity_get_x(store, enemy), jo_entity_get_y(store, enemy),
+                                                               jo_sprite_get_width(enemy_sprite_id), jo_sprite_get_height(enemy_sprite_id)))
     {
-        jo_list_remove(&enemies_list, node);
+        jo_entity_kill(store, enemy);
         having_shield = 0;
     }
-    else if (jo_hitbox_detection_custom_boundaries(enemy_sprite_id, node->data.coord.x, node->data.coord.y, ship.x, ship.y, 28, 20))
+    else if (jo_hitbox_pixel_overlap(enemy_sprite_id, jo_entity_get_x(store, enemy), jo_entity_get_y(store, enemy), false,
+                                     ship.reverse_animation ? jo_get_anim_sprite_reverse(ship.anim_id) : jo_get_anim_sprite(ship.anim_id), ship.x, ship.y,
+                                     ship.move == SHIP_MOVE_RIGHT))
     {
         gameover = 1;
-        jo_list_remove(&enemies_list, node);
+        jo_entity_kill(store, enemy);
     }
-    if (node->data.coord.y > JO_TV_HEIGHT_2 + 20)
-        jo_list_remove(&enemies_list, node);
 }
 
 /* static inline void         move_background(void)
@@ -152,12 +221,27 @@ static inline void         draw_enemy(jo_node *node)
 }
 */
 
-void                my_draw(void)
+/* Fixed timestep update phase: every game state change happens here (see jo_core_add_update_callback()) */
+void                my_update(void)
 {
-if (!gameover && enemies_list.count <= 0)
+    if (!gameover && enemies.count <= 0)
         next_level();
+    if (!gameover)
+        jo_bullet_emitter_update(&bullet_emitter, &enemy_bullets, ship.x, ship.y);
+    jo_entity_store_move_and_kill_outside(&laser_blasts, -JO_TV_WIDTH, -JO_TV_HEIGHT_2, JO_TV_WIDTH, JO_TV_HEIGHT);
+    jo_entity_store_move_and_kill_outside(&enemies, -JO_TV_WIDTH, -JO_MULT_BY_2(JO_TV_HEIGHT), JO_TV_WIDTH, JO_TV_HEIGHT_2 + 20);
+    jo_entity_store_move_and_kill_outside(&enemy_bullets, -JO_TV_WIDTH_2, -JO_TV_HEIGHT_2, JO_TV_WIDTH_2, JO_TV_HEIGHT_2);
+    update_colliders();
+    jo_collision_sap_find_pairs(&colliders_sap, colliders, MAX_COLLIDERS, check_if_laser_hit_enemy, JO_NULL);
+    jo_entity_store_foreach(&enemies, check_enemy);
+    if (!gameover)
+        check_enemy_bullets();
+}
 
-    draw_water(water_sprite_id, 96, 3);
+/* Render phase: called once per displayed frame */
+void                my_draw(void)
+{
+    draw_water(96, 3);
 
     jo_printf(1, 28, "OUMF Simulation Level: %d  ", level);
     jo_printf(1, 1, "Score: %d  ", ship.score);
@@ -167,11 +251,13 @@ if (!gameover && enemies_list.count <= 0)
 #ifdef JO_DEBUG
     jo_printf(1, 2, jo_get_last_error());
 #endif
+    jo_sprite_retained_set_visible(ship_instance, !gameover);
+    jo_sprite_retained_set_visible(shield_instance, !gameover && having_shield);
     if (!gameover)
     {
         draw_ship();
         if (having_shield)
-            jo_sprite_draw3D(shield_sprite_id, ship.x + ship.shield_pos.x, ship.y + ship.shield_pos.y, 520);
+            jo_sprite_retained_set_position(shield_instance, ship.x + ship.shield_pos.x, ship.y + ship.shield_pos.y);
     }
     else
 
@@ -186,8 +272,9 @@ if (!gameover && enemies_list.count <= 0)
     }
 
 
-    jo_list_foreach(&laser_blast_list, draw_laser_blast);
-    jo_list_foreach(&enemies_list, draw_enemy);
+    jo_entity_store_foreach(&laser_blasts, draw_entity);
+    jo_entity_store_foreach(&enemies, draw_entity);
+    jo_entity_store_foreach(&enemy_bullets, draw_entity);
   //  move_background();    Initial implementation makes me queezy so this stays disabled for now.
 }
 
@@ -202,8 +289,10 @@ static inline void         start_ship_animation(t_ship_horiz_move move, char is_
 void                restart_game(void)
 {
     jo_audio_play_cd_track(TRACK_LEVEL1, TRACK_LEVEL1, CD_LOOP);
-    jo_list_clear(&laser_blast_list);
-    jo_list_clear(&enemies_list);
+    jo_entity_store_clear(&laser_blasts);
+    jo_entity_store_clear(&enemies);
+    jo_entity_store_clear(&enemy_bullets);
+    jo_bullet_emitter_restart(&bullet_emitter);
     level = 0;
     ship.score = 0;
     gameover = 0;
@@ -213,12 +302,9 @@ void                restart_game(void)
 
 static inline void         shoot(void)
 {
-    if (laser_blast_list.count < 3) //limit laser amount
+    if (laser_blasts.count < MAX_LASER_BLASTS) //limit laser amount
     {
-    jo_list_data blast;
-    blast.coord.x = ship.x;
-    blast.coord.y = ship.y - 28;
-    jo_list_add(&laser_blast_list, blast);
+    jo_entity_spawn(&laser_blasts, JO_MULT_BY_65536(ship.x), JO_MULT_BY_65536(ship.y - 28), 0, -JO_MULT_BY_65536(4), blast_sprite_id);
     jo_audio_play_sound_on_channel(&blop, 0);
     }
 }
@@ -254,7 +340,7 @@ void			my_gamepad(void)
         shoot();
     if (jo_is_pad1_key_pressed(JO_KEY_B)) //Autofire!
         shoot();
-        asm("nop");
+    asm("nop");
     if (jo_is_pad1_key_down(JO_KEY_C))
         shoot();
     if (jo_is_pad1_key_pressed(JO_KEY_LEFT) && ship.x > -(JO_TV_WIDTH_2 - 16))
@@ -295,21 +381,33 @@ void            init_game(void)
         {0, 0, 40, 38},
     };
 
+    /* Pixel perfect collisions between enemies and the ship (see check_enemy()) */
+    jo_sprite_enable_collision_masks();
     first_ship_sprite_id = jo_sprite_add_tga_tileset(JO_ROOT_DIR, "SHIP.TGA", JO_COLOR_Red, ship_tileset, SHIP_TILE_COUNT);
     enemy_sprite_id = jo_sprite_add_tga(JO_ROOT_DIR, "EN.TGA", JO_COLOR_Blue);
+    jo_sprite_disable_collision_masks();
+    jo_hitbox_load_from_file(enemy_sprite_id, JO_ROOT_DIR, "EN.HIT");
 //  enemy2_sprite_id = jo_sprite_add_tga(JO_ROOT_DIR, "EN.TGA", JO_COLOR_Blue); SOON
     blast_sprite_id = jo_sprite_add_tga(JO_ROOT_DIR, "BLAST.TGA", JO_COLOR_Blue);
     shield_sprite_id = jo_sprite_add_tga(JO_ROOT_DIR, "SHIELD.TGA", JO_COLOR_Blue);
     ship.anim_id = jo_create_sprite_anim(first_ship_sprite_id, SHIP_TILE_COUNT, 3);
     water_sprite_id = jo_sprite_add_tga(JO_ROOT_DIR, "FOG.TGA", JO_COLOR_Green);
+    retain_water(water_sprite_id);
+    ship_instance = jo_sprite_retain(first_ship_sprite_id, 0, 0, SHIP_DEPTH);
+    shield_instance = jo_sprite_retain(shield_sprite_id, 0, 0, ENTITY_DEPTH);
     ship.speed = 4;
     ship.score = 0;
     ship.shield_pos.x = 0;
     ship.shield_pos.y = 0;
     ship.move = SHIP_MOVE_NONE;
     jo_storyboard_move_object_in_circle(&ship.shield_pos, 30, 4, JO_STORYBOARD_INFINITE_DURATION);
-    jo_list_init(&laser_blast_list);
-    jo_list_init(&enemies_list);
+    /* Entities are reserved once so shooting and spawning never touch the heap */
+    jo_entity_store_init(&laser_blasts, MAX_LASER_BLASTS);
+    jo_entity_store_init(&enemies, MAX_ENEMIES);
+    jo_entity_store_init(&enemy_bullets, MAX_ENEMY_BULLETS);
+    jo_bullet_emitter_init(&bullet_emitter, bullet_script, blast_sprite_id);
+    bullet_emitter.y = -JO_TV_HEIGHT_2 + 16;
+    jo_collision_sap_init(&colliders_sap, MAX_COLLIDERS);
 }
 
 void			jo_main(void)
@@ -319,7 +417,8 @@ void			jo_main(void)
     jo_set_background_sprite(&SpriteBg, 0, 0);
     init_game();
     jo_audio_play_cd_track(TRACK_LEVEL1, TRACK_LEVEL1, CD_LOOP);
-    jo_core_add_callback(my_gamepad);
+    jo_core_add_update_callback(my_gamepad);
+    jo_core_add_update_callback(my_update);
 	jo_core_add_callback(my_draw);
 //    jo_core_add_callback(gimme_date);
     jo_core_run();